@@ -0,0 +1,166 @@
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <chrono>
+#include <memory>
+#include <cctype>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <map>
+#include <vector>
+
+#include <scm.h>
+#include <scm_factory.h>
+#include <adder_graph_table.h>
+#include <null_buffer.h>
+
+int main(int argc, char** argv) {
+	std::string filename;
+	int max_bits = 0;
+	std::string solver_name = "no_solver";
+	int timeout = 300;
+	int jobs = 1;
+	bool also_minimize_full_adders = false;
+	bool allow_node_output_shift = false;
+	bool allow_negative_numbers = false;
+#ifdef USE_Z3
+	solver_name = "z3";
+#endif
+#ifdef USE_SYRUP
+	solver_name = "syrup";
+#endif
+#ifdef USE_CADICAL
+	solver_name = "cadical";
+#endif
+	if (argc < 3) {
+		std::cout << "Please call satscm_table like this: ./satscm_table <table file> <max bits> <solver name> <timeout> <jobs> <minimize full adders> <allow post adder right shfits> <allow negative coefficients>" << std::endl;
+		std::cout << "  => table file: <string>: path of the table that is created" << std::endl;
+		std::cout << "  => max bits: <uint>: all odd constants < 2^(max bits) are solved" << std::endl;
+		std::cout << "  => solver name: <string>: cadical, z3, syrup, portfolio" << std::endl;
+		std::cout << "  => timeout: <uint>: number of seconds allowed per SAT instance (constants that time out are not marked as optimal)" << std::endl;
+		std::cout << "  => jobs: <uint>: number of constants that are solved in parallel" << std::endl;
+		std::cout << "  => minimize full adders: <0/1>: minimize the full adder count for the optimal number of adders by setting this to 1" << std::endl;
+		std::cout << "  => allow post adder right shifts: <0/1>: account for the optional right shift after the addition" << std::endl;
+		std::cout << "  => allow negative coefficients: <0/1>: allow the use of negative coefficients to decrease the FA count" << std::endl;
+		return 0;
+	}
+	filename = argv[1];
+	{
+		std::string s(argv[2]);
+		try {
+			max_bits = std::stoi(s);
+		}
+		catch (...) {
+			std::stringstream err_msg;
+			err_msg << "failed to convert " << s << " to integer" << std::endl;
+			throw std::runtime_error(err_msg.str());
+		}
+	}
+	if (argc > 3) {
+		std::string s(argv[3]);
+		std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c){return std::tolower(c);});
+		solver_name = s;
+	}
+	if (argc > 4) {
+		std::string s(argv[4]);
+		try {
+			timeout = std::stoi(s);
+		}
+		catch (...) {
+			std::stringstream err_msg;
+			err_msg << "failed to convert " << s << " to integer" << std::endl;
+			throw std::runtime_error(err_msg.str());
+		}
+	}
+	if (argc > 5) {
+		std::string s(argv[5]);
+		try {
+			jobs = std::max(1, std::stoi(s));
+		}
+		catch (...) {
+			std::stringstream err_msg;
+			err_msg << "failed to convert " << s << " to integer" << std::endl;
+			throw std::runtime_error(err_msg.str());
+		}
+	}
+	if (argc > 6) {
+		std::string s(argv[6]);
+		try {
+			also_minimize_full_adders = (bool)std::stoi(s);
+		}
+		catch (...) {
+			std::stringstream err_msg;
+			err_msg << "failed to convert " << s << " to 1/0" << std::endl;
+			throw std::runtime_error(err_msg.str());
+		}
+	}
+	if (argc > 7) {
+		std::string s(argv[7]);
+		try {
+			allow_node_output_shift = (bool)std::stoi(s);
+		}
+		catch (...) {
+			std::stringstream err_msg;
+			err_msg << "failed to convert " << s << " to 1/0" << std::endl;
+			throw std::runtime_error(err_msg.str());
+		}
+	}
+	if (argc > 8) {
+		std::string s(argv[8]);
+		try {
+			allow_negative_numbers = (bool)std::stoi(s);
+		}
+		catch (...) {
+			std::stringstream err_msg;
+			err_msg << "failed to convert " << s << " to 1/0" << std::endl;
+			throw std::runtime_error(err_msg.str());
+		}
+	}
+	if (max_bits < 1 or max_bits > 31) throw std::runtime_error("max bits must be in [1, 31]");
+	uint32_t flags = 0;
+	if (also_minimize_full_adders) flags |= adder_graph_table::minimize_full_adders;
+	if (allow_node_output_shift) flags |= adder_graph_table::node_output_shift;
+	if (allow_negative_numbers) flags |= adder_graph_table::negative_numbers;
+	std::cerr << "Generating adder graph table for all odd constants < 2^" << max_bits << " with solver " << solver_name << " and " << jobs << " jobs" << std::endl;
+	auto start_time = std::chrono::steady_clock::now();
+	// the solvers are very chatty -> only print the progress
+	null_buffer discarded_output;
+	auto original_output = std::cout.rdbuf(&discarded_output);
+	std::ostream progress(std::cerr.rdbuf(&discarded_output));
+	std::map<int64_t, adder_graph_table::entry> entries;
+	entries[1] = {0, true, true, "{}"};
+	std::mutex entries_mutex;
+	std::atomic<int64_t> next_constant(3);
+	int64_t limit = ((int64_t)1) << max_bits;
+	std::vector<std::thread> workers;
+	for (int j = 0; j < jobs; j++) {
+		workers.emplace_back([&]() {
+			for (int64_t c = next_constant.fetch_add(2); c < limit; c = next_constant.fetch_add(2)) {
+				auto solver = create_scm(solver_name, {(int)c}, timeout, true, 1, allow_negative_numbers, false);
+				if (also_minimize_full_adders) solver->also_minimize_full_adders();
+				if (allow_node_output_shift) solver->allow_node_output_shift();
+				solver->solve();
+				auto [add_opt, fa_opt] = solver->solution_is_optimal();
+				auto graph = solver->get_adder_graph();
+				std::lock_guard<std::mutex> lock(entries_mutex);
+				if (graph.empty()) {
+					progress << "  failed to find solution for constant " << c << std::endl;
+					continue;
+				}
+				entries[c] = {(int)graph.size(), add_opt == 1, also_minimize_full_adders and fa_opt == 1, solver->get_adder_graph_description()};
+				if (entries.size() % 1000 == 0) progress << "  solved " << entries.size() << " of " << limit/2 << " constants" << std::endl;
+			}
+		});
+	}
+	for (auto &t : workers) {
+		t.join();
+	}
+	std::cout.rdbuf(original_output);
+	std::cerr.rdbuf(progress.rdbuf());
+	adder_graph_table::write(filename, max_bits, flags, entries);
+	auto elapsed_time = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_time).count() / 1000.0;
+	std::cerr << "Wrote " << entries.size() << " adder graphs to " << filename << " after " << elapsed_time << " seconds" << std::endl;
+	return 0;
+}
@@ -5,20 +5,32 @@
 #include <memory>
 #include <cctype>
 #include <algorithm>
+#include <fstream>
+#include <thread>
+#include <tuple>
+#include <atomic>
+#include <csignal>
 
 #include <scm.h>
+#include <scm_factory.h>
+#include <adder_graph_table.h>
+#include <result_cache.h>
+#include <batch.h>
+#include <cnf_writer.h>
+#include <cnf_reader.h>
+#include <null_buffer.h>
+#include <json_record.h>
 
-#ifdef USE_CADICAL
-#include <scm_cadical.h>
-#endif
+/*!
+ * set by SIGINT/SIGTERM in anytime mode
+ */
+static std::atomic<int> received_signal = 0;
 
-#ifdef USE_Z3
-#include <scm_z3.h>
-#endif
-
-#ifdef USE_SYRUP
-#include <scm_syrup.h>
-#endif
+static void handle_stop_signal(int sig) {
+	received_signal = sig;
+	// a second signal terminates immediately
+	std::signal(sig, SIG_DFL);
+}
 
 int main(int argc, char** argv) {
 	std::unique_ptr<scm> solver;
@@ -31,8 +43,26 @@ int main(int argc, char** argv) {
 	bool also_minimize_full_adders = false;
 	bool allow_node_output_shift = false;
 	bool write_cnf = false;
+	cnf_writer::format cnf_format;
 	int allow_coefficient_sign_inversion = 0;
 	int min_num_add = -1;
+	bool incremental = false;
+	int parallel_adder_counts = 1;
+	scm::full_adder_search full_adder_search = scm::linear_FA_search;
+	scm::adder_search adder_search = scm::bottom_up_adder_search;
+	bool use_heuristic = false;
+	std::string table_filename;
+	std::string cache_directory;
+	std::string batch_input;
+	std::string cnf_input;
+	bool symmetry_breaking = false;
+	double time_budget_seconds = 0.0;
+	bool anytime = false;
+	int cube_workers = 1;
+	int lns_workers = 0;
+	int cluster_size = 0;
+	int restricted_max_shift = 0;
+	int batch_jobs = (int)std::max(1u, std::thread::hardware_concurrency());
 #ifdef USE_Z3
 	solver_name = "z3";
 #endif
@@ -43,21 +73,48 @@ int main(int argc, char** argv) {
 	solver_name = "cadical";
 #endif
 	if (argc == 1) {
-		std::cout << "Please call satscm like this: ./satscm <constant(s)> <solver name> <timeout> <threads> <quiet> <minimize full adders> <allow post adder right shfits> <allow negative coefficients> <write cnf files> <allow coefficient sign inversion> <min num add>" << std::endl;
+		std::cout << "Please call satscm like this: ./satscm <constant(s)> <solver name> <timeout> <threads> <quiet> <minimize full adders> <allow post adder right shfits> <allow negative coefficients> <write cnf files> <allow coefficient sign inversion> <min num add> <incremental> <parallel adder counts> <FA search> <heuristic> <table file> <cache directory> <batch jobs> <symmetry breaking> <time budget> <anytime> <cube workers> <LNS workers> <cluster size> <quick max shift> <adder search>" << std::endl;
 		std::cout << "  => constant(s): <int:int:...>: colon-separated list of integers that should be computed" << std::endl;
-		std::cout << "  => solver name: <string>: cadical, z3, syrup are supported" << std::endl;
+		std::cout << "     or - / @<file>: batch mode that reads one problem per line (<int:int:...> [timeout]) from stdin / the file and prints one JSON record per problem" << std::endl;
+		std::cout << "  => solver name: <string>: cadical, z3, syrup are supported; portfolio runs all linked solvers in parallel and uses the first answer" << std::endl;
+		std::cout << "     ipasir:<shared library> loads an incremental solver that implements the IPASIR interface (e.g., ipasir:/usr/lib/libipasircadical.so)" << std::endl;
+		std::cout << "     external:<command> / external@<memory limit in MB>:<command> pipes each SAT problem to a DIMACS solver executable (e.g., external:kissat)" << std::endl;
 		std::cout << "  => timeout: <uint>: number of seconds allowed per SAT instance" << std::endl;
-		std::cout << "  => threads: <uint>: number of threads allowed to use" << std::endl;
+		std::cout << "  => threads: <uint>: number of threads allowed to use (portfolio: number of solver instances that run in parallel)" << std::endl;
 		std::cout << "  => quiet: <0/1>: suppress debug outputs by setting this to 1" << std::endl;
 		std::cout << "  => minimize full adders: <0/1>: minimize the full adder count for the optimal number of adders by setting this to 1" << std::endl;
 		std::cout << "  => allow post adder right shifts: <0/1>: account for the optional right shift after the addition" << std::endl;
 		std::cout << "  => allow negative coefficients: <0/1>: allow the use of negative coefficients to decrease the FA count" << std::endl;
-		std::cout << "  => write cnf files: <0/1>: write all SAT programs to CNF files" << std::endl;
+		std::cout << "  => write cnf files: <0/1/format>: write all SAT programs to CNF files" << std::endl;
+		std::cout << "     format: cnf (DIMACS, same as 1), bcnf (binary DIMACS), optionally compressed: cnf.gz, bcnf.gz, cnf.xz, bcnf.xz" << std::endl;
 		std::cout << "  => allow coefficient sign inversion: <0/1/-1>: 1 - allow the SAT solver to invert the sign of ANY requested coefficient to reduce the FA count; -1 - only allow it if for negative requested coefficients; 0 - never allow it" << std::endl;
 		std::cout << "  => min num add: <uint>: lower limit for the adder count (default: number of unique odd coefficients excluding 0 and 1)" << std::endl;
+		std::cout << "  => incremental: <0/1>: keep the solver (and everything it learned) when increasing the adder count instead of rebuilding the problem (needs a backend that supports assumptions, i.e., cadical or z3)" << std::endl;
+		std::cout << "  => parallel adder counts: <uint>: number of adder counts that are solved at the same time in separate solver instances (default: 1)" << std::endl;
+		std::cout << "  => FA search: <linear/binary/core>: how the full adder limit is chosen when minimizing full adders (default: linear)" << std::endl;
+		std::cout << "  => heuristic: <0/1>: compute a heuristic solution first to bound the adder count and to seed the solver phases" << std::endl;
+		std::cout << "  => table file: <string>: look up single constants in a table generated by satscm_table (default: - for none)" << std::endl;
+		std::cout << "  => cache directory: <string>: reuse and store results in this directory (default: - for none)" << std::endl;
+		std::cout << "  => batch jobs: <uint>: number of problems that are solved in parallel in batch mode and number of clusters that are solved in parallel (default: number of cores)" << std::endl;
+		std::cout << "  => symmetry breaking: <0/1>: rule out equivalent adder graphs (node order, operand order, duplicate nodes) to speed up infeasibility proofs" << std::endl;
+		std::cout << "  => time budget: <uint>: total wall-clock seconds for the whole run; the timeout still limits each SAT call (default: 0 for unlimited)" << std::endl;
+		std::cout << "  => anytime: <0/1>: only print one JSON record per improved solution (with its proven bounds) to stdout and a final record when the search ends, the time budget runs out or satscm receives SIGINT/SIGTERM" << std::endl;
+		std::cout << "  => cube workers: <uint>: number of threads that solve each SAT problem together by splitting it into cubes over the inputs, shifts and signs of the first nodes (needs a backend that supports assumptions; default: 1 for no splitting)" << std::endl;
+		std::cout << "  => LNS workers: <uint>: improve the heuristic solution with a large neighbourhood search on this many threads instead of searching for the optimum; it runs for the time budget (or the timeout without budget) and re-optimizes windows of 4 nodes (needs a backend that supports assumptions; default: 0 for the exact search)" << std::endl;
+		std::cout << "  => cluster size: <uint>: split larger constant sets into clusters of at most this many constants that share many subexpressions, solve the clusters in parallel with half of the time budget and improve the merged solution with the large neighbourhood search (the result is not proven optimal; default: 0 for no splitting)" << std::endl;
+		std::cout << "  => quick max shift: <uint>: first try each adder count with shifts up to this value and node values that fit into the bit width of the largest constant; the full problem is only solved if that fails (the result is still optimal; default: 0 for no restricted pass)" << std::endl;
+		std::cout << "  => adder search: <bottomup/topdown/binary>: how the adder count is chosen; top-down and binary search start at the heuristic or cached solution (bottom-up without one; default: bottomup)" << std::endl;
+		std::cout << "Or solve a CNF file that was written by satscm and decode the adder graph: ./satscm <cnf file> <solver name> <timeout> <threads> <quiet>" << std::endl;
+		std::cout << "  => cnf file: <string>: file with one of the extensions above (the variable map <name>.map written next to it is needed as well)" << std::endl;
 		return 0;
 	}
-	if (argc > 1) {
+	if (argc > 1 and (std::string(argv[1]) == "-" or argv[1][0] == '@')) {
+		batch_input = argv[1];
+	}
+	else if (argc > 1 and !cnf_reader::strip_extension(argv[1]).empty()) {
+		cnf_input = argv[1];
+	}
+	else if (argc > 1) {
 		std::string s(argv[1]);
 		try {
 			std::stringstream c_str(s);
@@ -74,7 +131,9 @@ int main(int argc, char** argv) {
 	}
 	if (argc > 2) {
 		std::string s(argv[2]);
-		std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c){return std::tolower(c);});
+		// keep the command of external solvers as it is
+		auto name_end = std::min(s.find(':'), s.size());
+		std::transform(s.begin(), s.begin()+name_end, s.begin(), [](unsigned char c){return std::tolower(c);});
 		solver_name = s;
 	}
 	if (argc > 3) {
@@ -145,13 +204,13 @@ int main(int argc, char** argv) {
 	}
 	if (argc > 9) {
 		std::string s(argv[9]);
-		try {
-			write_cnf = (bool)std::stoi(s);
+		if (s == "0" or s == "1") {
+			write_cnf = s == "1";
 		}
-		catch (...) {
-			std::stringstream err_msg;
-			err_msg << "failed to convert " << s << " to 1/0" << std::endl;
-			throw std::runtime_error(err_msg.str());
+		else {
+			// file extension that selects the format
+			write_cnf = true;
+			cnf_format = cnf_writer::parse_format(s);
 		}
 	}
 	if (argc > 10) {
@@ -176,39 +235,263 @@ int main(int argc, char** argv) {
 			throw std::runtime_error(err_msg.str());
 		}
 	}
+	if (argc > 12) {
+		std::string s(argv[12]);
+		try {
+			incremental = (bool)std::stoi(s);
+		}
+		catch (...) {
+			std::stringstream err_msg;
+			err_msg << "failed to convert " << s << " to 1/0" << std::endl;
+			throw std::runtime_error(err_msg.str());
+		}
+	}
+	if (argc > 13) {
+		std::string s(argv[13]);
+		try {
+			parallel_adder_counts = std::stoi(s);
+		}
+		catch (...) {
+			std::stringstream err_msg;
+			err_msg << "failed to convert " << s << " to int" << std::endl;
+			throw std::runtime_error(err_msg.str());
+		}
+	}
+	if (argc > 14) {
+		std::string s(argv[14]);
+		std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c){return std::tolower(c);});
+		if (s == "linear") full_adder_search = scm::linear_FA_search;
+		else if (s == "binary") full_adder_search = scm::binary_FA_search;
+		else if (s == "core") full_adder_search = scm::core_guided_FA_search;
+		else throw std::runtime_error("unknown FA search '"+s+"'");
+	}
+	if (argc > 15) {
+		std::string s(argv[15]);
+		try {
+			use_heuristic = (bool)std::stoi(s);
+		}
+		catch (...) {
+			std::stringstream err_msg;
+			err_msg << "failed to convert " << s << " to 1/0" << std::endl;
+			throw std::runtime_error(err_msg.str());
+		}
+	}
+	if (argc > 16 and std::string(argv[16]) != "-") {
+		table_filename = argv[16];
+	}
+	if (argc > 17 and std::string(argv[17]) != "-") {
+		cache_directory = argv[17];
+	}
+	if (argc > 18) {
+		std::string s(argv[18]);
+		try {
+			batch_jobs = std::stoi(s);
+		}
+		catch (...) {
+			std::stringstream err_msg;
+			err_msg << "failed to convert " << s << " to int" << std::endl;
+			throw std::runtime_error(err_msg.str());
+		}
+	}
+	if (argc > 19) {
+		std::string s(argv[19]);
+		try {
+			symmetry_breaking = (bool)std::stoi(s);
+		}
+		catch (...) {
+			std::stringstream err_msg;
+			err_msg << "failed to convert " << s << " to 1/0" << std::endl;
+			throw std::runtime_error(err_msg.str());
+		}
+	}
+	if (argc > 20) {
+		std::string s(argv[20]);
+		try {
+			time_budget_seconds = std::stod(s);
+		}
+		catch (...) {
+			std::stringstream err_msg;
+			err_msg << "failed to convert " << s << " to number" << std::endl;
+			throw std::runtime_error(err_msg.str());
+		}
+	}
+	if (argc > 21) {
+		std::string s(argv[21]);
+		try {
+			anytime = (bool)std::stoi(s);
+		}
+		catch (...) {
+			std::stringstream err_msg;
+			err_msg << "failed to convert " << s << " to 1/0" << std::endl;
+			throw std::runtime_error(err_msg.str());
+		}
+	}
+	if (argc > 22) {
+		std::string s(argv[22]);
+		try {
+			cube_workers = std::stoi(s);
+		}
+		catch (...) {
+			std::stringstream err_msg;
+			err_msg << "failed to convert " << s << " to int" << std::endl;
+			throw std::runtime_error(err_msg.str());
+		}
+	}
+	if (argc > 23) {
+		std::string s(argv[23]);
+		try {
+			lns_workers = std::stoi(s);
+		}
+		catch (...) {
+			std::stringstream err_msg;
+			err_msg << "failed to convert " << s << " to int" << std::endl;
+			throw std::runtime_error(err_msg.str());
+		}
+	}
+	if (argc > 24) {
+		std::string s(argv[24]);
+		try {
+			cluster_size = std::stoi(s);
+		}
+		catch (...) {
+			std::stringstream err_msg;
+			err_msg << "failed to convert " << s << " to int" << std::endl;
+			throw std::runtime_error(err_msg.str());
+		}
+	}
+	if (argc > 25) {
+		std::string s(argv[25]);
+		try {
+			restricted_max_shift = std::stoi(s);
+		}
+		catch (...) {
+			std::stringstream err_msg;
+			err_msg << "failed to convert " << s << " to int" << std::endl;
+			throw std::runtime_error(err_msg.str());
+		}
+	}
+	if (argc > 26) {
+		std::string s(argv[26]);
+		std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c){return std::tolower(c);});
+		if (s == "bottomup") adder_search = scm::bottom_up_adder_search;
+		else if (s == "topdown") adder_search = scm::top_down_adder_search;
+		else if (s == "binary") adder_search = scm::binary_adder_search;
+		else throw std::runtime_error("unknown adder search '"+s+"'");
+	}
+	std::shared_ptr<const adder_graph_table> table;
+	if (!table_filename.empty()) table = std::make_shared<adder_graph_table>(table_filename);
+	std::shared_ptr<const result_cache> cache;
+	if (!cache_directory.empty()) cache = std::make_shared<result_cache>(cache_directory);
+	auto create_solver = [&](const std::vector<int> &C, int timeout) {
+		auto solver = create_scm(solver_name, C, timeout, quiet, threads, allow_negative_numbers, write_cnf);
+		if (also_minimize_full_adders) solver->also_minimize_full_adders();
+		if (allow_node_output_shift) solver->allow_node_output_shift();
+		if (allow_coefficient_sign_inversion != 0) solver->ignore_sign(allow_coefficient_sign_inversion == -1);
+		if (min_num_add >= 0) solver->set_min_add(min_num_add);
+		if (incremental) solver->solve_incrementally();
+		if (parallel_adder_counts > 1) solver->set_parallel_adder_counts(parallel_adder_counts);
+		if (cube_workers > 1) solver->set_cube_and_conquer(cube_workers);
+		if (lns_workers > 0) solver->use_large_neighbourhood_search(lns_workers);
+		if (cluster_size > 0) solver->use_partitioning(cluster_size, batch_jobs);
+		if (restricted_max_shift > 0) solver->use_restricted_domain_pass(restricted_max_shift);
+		solver->set_full_adder_search(full_adder_search);
+		solver->set_adder_search(adder_search);
+		if (use_heuristic) solver->use_heuristic_start_solution();
+		if (symmetry_breaking) solver->use_symmetry_breaking();
+		if (time_budget_seconds > 0.0) solver->set_time_budget(time_budget_seconds);
+		solver->set_cnf_format(cnf_format);
+		if (table != nullptr) solver->set_adder_graph_table(table);
+		if (cache != nullptr) solver->set_result_cache(cache);
+		return solver;
+	};
+	if (!batch_input.empty()) {
+		std::ifstream input_file;
+		if (batch_input != "-") {
+			input_file.open(batch_input.substr(1));
+			if (!input_file) throw std::runtime_error("failed to open "+batch_input.substr(1));
+		}
+		std::istream &input = batch_input == "-" ? std::cin : input_file;
+		// stdout only contains the result records
+		std::ostream records(std::cout.rdbuf());
+		null_buffer discarded_output;
+		std::cout.rdbuf(&discarded_output);
+		std::ostream messages(std::cerr.rdbuf(&discarded_output));
+		auto start_time = std::chrono::steady_clock::now();
+		auto num_solved = solve_batch(input, records, batch_jobs, timeout, create_solver);
+		auto elapsed_time = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_time).count() / 1000.0;
+		messages << "Solved " << num_solved << " problems with " << batch_jobs << " jobs after " << elapsed_time << " seconds" << std::endl;
+		std::cout.rdbuf(records.rdbuf());
+		std::cerr.rdbuf(messages.rdbuf());
+		return 0;
+	}
+	if (!cnf_input.empty()) {
+		// the constants and number representation are needed to set up the solver before the CNF file is loaded
+		std::tie(C, allow_negative_numbers) = scm::read_cnf_problem(cnf_input);
+		std::cout << "Solving " << cnf_input << " with " << timeout << " seconds timeout with solver " << solver_name << " and " << threads << " allowed threads" << std::endl;
+		auto start_time = std::chrono::steady_clock::now();
+		solver = create_scm(solver_name, C, timeout, quiet, threads, allow_negative_numbers, false);
+		solver->solve_cnf_file(cnf_input);
+		auto elapsed_time = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_time).count() / 1000.0;
+		std::cerr << "Finished solving after " << elapsed_time << " seconds" << std::endl;
+		solver->print_solution();
+		return 0;
+	}
+	if (anytime) {
+		// stdout only contains the solution records
+		std::ostream records(std::cout.rdbuf());
+		null_buffer discarded_output;
+		std::cout.rdbuf(&discarded_output);
+		auto start_time = std::chrono::steady_clock::now();
+		auto get_elapsed_time = [&]() {
+			return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_time).count() / 1000.0;
+		};
+		solver = create_solver(C, timeout);
+		solver->set_solution_listener([&](scm &s) {
+			std::stringstream record;
+			record << "{\"status\":\"improved\",\"time\":" << get_elapsed_time();
+			write_solution_fields(record, s, false);
+			record << "}";
+			// flush each record so that it survives if we are killed
+			records << record.str() << std::endl;
+		});
+		// stop the solver from another thread because interrupting it is not async-signal-safe
+		std::signal(SIGINT, handle_stop_signal);
+		std::signal(SIGTERM, handle_stop_signal);
+		std::atomic<bool> solving = true;
+		std::thread watchdog([&]() {
+			while (solving) {
+				// repeat this until the solver is done because it might not have started solving yet
+				if (received_signal != 0) solver->interrupt();
+				std::this_thread::sleep_for(std::chrono::milliseconds(10));
+			}
+		});
+		try {
+			solver->solve();
+		}
+		catch (...) {
+			solving = false;
+			watchdog.join();
+			throw;
+		}
+		solving = false;
+		watchdog.join();
+		std::stringstream record;
+		record << "{\"status\":\"" << (solver->get_adder_graph().empty() ? "no_solution" : "final") << "\",\"time\":" << get_elapsed_time();
+		record << ",\"constants\":" << json_array(C);
+		if (received_signal != 0) record << ",\"signal\":" << received_signal;
+		if (!solver->get_adder_graph().empty()) write_solution_fields(record, *solver, true);
+		record << "}";
+		records << record.str() << std::endl;
+		std::cout.rdbuf(records.rdbuf());
+		return 0;
+	}
 	std::cout << "Starting OSCM for constant" << (C.size()>1?"s\n":" ");
 	for (auto &c : C) {
 		std::cout << (C.size()>1?"  ":"") << c << (C.size()>1?"\n":" ");
 	}
 	std::cout << "and " << timeout << " seconds timeout with solver " << solver_name << " and " << threads << " allowed threads" << std::endl;
 	auto start_time = std::chrono::steady_clock::now();
-	if (solver_name == "cadical") {
-#ifdef USE_CADICAL
-		solver = std::make_unique<scm_cadical>(C, timeout, quiet, allow_negative_numbers, write_cnf);
-#else
-		throw std::runtime_error("Link CaDiCaL lib to use CaDiCaL backend");
-#endif
-	}
-	else if (solver_name == "syrup" or solver_name == "glucose" or solver_name == "glucose-syrup") {
-#ifdef USE_SYRUP
-		solver = std::make_unique<scm_syrup>(C, timeout, quiet, threads, allow_negative_numbers, write_cnf);
-#else
-		throw std::runtime_error("Link Glucose-Syrup lib to use syrup backend");
-#endif
-	}
-	else if (solver_name == "z3") {
-#ifdef USE_Z3
-		solver = std::make_unique<scm_z3>(C, timeout, quiet, threads, allow_negative_numbers, write_cnf);
-#else
-		throw std::runtime_error("Link Z3 lib to use Z3 backend");
-#endif
-	}
-	else
-		throw std::runtime_error("unknown solver name '"+solver_name+"'");
-	if (also_minimize_full_adders) solver->also_minimize_full_adders();
-	if (allow_node_output_shift) solver->allow_node_output_shift();
-	if (allow_coefficient_sign_inversion != 0) solver->ignore_sign(allow_coefficient_sign_inversion == -1);
-	if (min_num_add >= 0) solver->set_min_add(min_num_add);
+	solver = create_solver(C, timeout);
 	solver->solve();
 	auto elapsed_time = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_time).count() / 1000.0;
 	std::cerr << "Finished solving after " << elapsed_time << " seconds" << std::endl;
@@ -216,5 +499,9 @@ int main(int argc, char** argv) {
 	auto [a,b] = solver->solution_is_optimal();
 	std::cerr << "#Add optimal = " << a << std::endl;
 	std::cerr << "#FAs optimal = " << b << std::endl;
+	if (also_minimize_full_adders) {
+		auto [lower, upper] = solver->get_full_adder_bounds();
+		std::cerr << "#FAs bounds = [" << lower << ", " << upper << "]" << std::endl;
+	}
 	return 0;
 }
\ No newline at end of file
@@ -0,0 +1,229 @@
+//
+// Created by nfiege on 11/16/22.
+//
+
+#include "adder_graph.h"
+#include <map>
+#include <set>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <cctype>
+
+/*!
+ * create a node that computes value from (values[left] << shift) and values[right] (if possible)
+ * @return whether it is possible
+ */
+static bool create_node(const std::vector<int64_t> &values, int left, int right, int shift, int64_t value, adder_graph_node &node) {
+	auto l = values[left] << shift;
+	auto r = values[right];
+	node.left_input = left;
+	node.right_input = right;
+	node.shift = shift;
+	node.value = value;
+	if (l + r == value) {
+		node.negate_select = 1;
+		node.subtract = 0;
+		return true;
+	}
+	if (l - r == value) {
+		node.negate_select = 1;
+		node.subtract = 1;
+		return true;
+	}
+	if (r - l == value) {
+		node.negate_select = 0;
+		node.subtract = 1;
+		return true;
+	}
+	return false;
+}
+
+/*!
+ * @return all odd positive values (that are not yet computed) that can be computed with one additional adder
+ */
+static std::map<int64_t, adder_graph_node> get_successors(const std::vector<int64_t> &values, const std::set<int64_t> &computed, int64_t limit, int max_shift) {
+	std::map<int64_t, adder_graph_node> successors;
+	for (int left = 0; left < (int)values.size(); left++) {
+		for (int shift = 1; shift <= max_shift; shift++) {
+			auto l = values[left] << shift;
+			if (l >= limit) break;
+			for (int right = 0; right < (int)values.size(); right++) {
+				auto r = values[right];
+				for (auto value : {l + r, std::abs(l - r)}) {
+					if (value >= limit or computed.find(value) != computed.end() or successors.find(value) != successors.end()) continue;
+					create_node(values, left, right, shift, value, successors[value]);
+				}
+			}
+		}
+	}
+	return successors;
+}
+
+/*!
+ * @return whether target can be computed with one adder from value and the existing values
+ */
+static bool is_reachable(int64_t target, int64_t value, const std::vector<int64_t> &values, int64_t limit, int max_shift) {
+	auto check = [&](int64_t other) {
+		for (int shift = 1; shift <= max_shift; shift++) {
+			auto a = value << shift;
+			if (a < limit and (a + other == target or std::abs(a - other) == target)) return true;
+			auto b = other << shift;
+			if (b < limit and (b + value == target or std::abs(b - value) == target)) return true;
+		}
+		return false;
+	};
+	if (check(value)) return true;
+	for (auto &other : values) {
+		if (check(other)) return true;
+	}
+	return false;
+}
+
+/*!
+ * @return < digit, position > of all non-zero digits of x starting at the LSB
+ */
+static std::vector<std::pair<int, int>> get_digits(int64_t x, bool csd) {
+	std::vector<std::pair<int, int>> digits;
+	int position = 0;
+	while (x != 0) {
+		if (x & 1) {
+			int digit = (csd and (x & 3) == 3) ? -1 : 1;
+			digits.emplace_back(digit, position);
+			x -= digit;
+		}
+		x >>= 1;
+		position++;
+	}
+	return digits;
+}
+
+/*!
+ * find the first partial sum of the representation of target that is not computed yet
+ * @return whether the node is valid w.r.t. the limits
+ */
+static bool create_partial_sum_node(int64_t target, bool csd, const std::vector<int64_t> &values, const std::set<int64_t> &computed, int64_t limit, int max_shift, adder_graph_node &node) {
+	auto digits = get_digits(target, csd);
+	int64_t partial_sum = digits.front().first;
+	for (int k = 1; k < (int)digits.size(); k++) {
+		auto last_partial_sum = std::abs(partial_sum);
+		auto [digit, position] = digits[k];
+		partial_sum += ((int64_t)digit) << position;
+		if (computed.find(std::abs(partial_sum)) != computed.end()) continue;
+		if (position > max_shift or (((int64_t)1) << position) >= limit or std::abs(partial_sum) >= limit) return false;
+		int right = 0;
+		while (values[right] != last_partial_sum) right++;
+		return create_node(values, 0, right, position, std::abs(partial_sum), node);
+	}
+	return false;
+}
+
+std::vector<adder_graph_node> create_heuristic_adder_graph(const std::vector<int> &C, int max_bits, int max_shift) {
+	int64_t limit = ((int64_t)1) << max_bits;
+	std::vector<adder_graph_node> graph;
+	std::vector<int64_t> values = {1};
+	std::set<int64_t> computed = {1};
+	std::set<int64_t> targets;
+	for (auto &c : C) {
+		int64_t t = std::abs((int64_t)c);
+		if (t == 0) continue;
+		while ((t & 1) == 0) t >>= 1;
+		if (t != 1) targets.insert(t);
+	}
+	auto add_node = [&](const adder_graph_node &node) {
+		graph.emplace_back(node);
+		values.emplace_back(node.value);
+		computed.insert(node.value);
+		targets.erase(node.value);
+	};
+	while (!targets.empty()) {
+		auto successors = get_successors(values, computed, limit, max_shift);
+		// 1) compute the smallest target that is reachable with one adder
+		bool found_target = false;
+		for (auto &t : targets) {
+			if (successors.find(t) == successors.end()) continue;
+			add_node(successors.at(t));
+			found_target = true;
+			break;
+		}
+		if (found_target) continue;
+		// 2) add the successor that brings most targets into reach (prefer small values on ties)
+		int best_benefit = 0;
+		int64_t best_value = 0;
+		for (auto &it : successors) {
+			int benefit = 0;
+			for (auto &t : targets) {
+				if (is_reachable(t, it.first, values, limit, max_shift)) benefit++;
+			}
+			if (benefit > best_benefit) {
+				best_benefit = benefit;
+				best_value = it.first;
+			}
+		}
+		if (best_benefit > 0) {
+			add_node(successors.at(best_value));
+			continue;
+		}
+		// 3) nothing helps -> shift-add decomposition of the smallest target
+		adder_graph_node node;
+		auto t = *targets.begin();
+		if (create_partial_sum_node(t, true, values, computed, limit, max_shift, node) or create_partial_sum_node(t, false, values, computed, limit, max_shift, node)) {
+			add_node(node);
+			continue;
+		}
+		throw std::runtime_error("failed to create heuristic adder graph for constant "+std::to_string(t));
+	}
+	return graph;
+}
+
+std::vector<adder_graph_node> parse_adder_graph_description(const std::string &description, bool node_output_shift) {
+	// all numbers in order of appearance (the node type 'A' is skipped)
+	std::vector<int64_t> numbers;
+	for (size_t pos = 0; pos < description.size(); pos++) {
+		if (!std::isdigit(description[pos]) and description[pos] != '-') continue;
+		size_t length = 0;
+		numbers.emplace_back(std::stoll(description.substr(pos), &length));
+		pos += length-1;
+	}
+	// value, stage, [post adder shift], left value, left stage, left shift, right value, right stage, right shift
+	int numbers_per_node = node_output_shift ? 9 : 8;
+	if (numbers.size() % numbers_per_node != 0) throw std::runtime_error("invalid adder graph description "+description);
+	std::vector<adder_graph_node> graph;
+	std::map<int64_t, int> node_index = {{1, 0}};
+	auto get_node_index = [&](int64_t value) {
+		auto it = node_index.find(value);
+		if (it == node_index.end()) throw std::runtime_error("invalid adder graph description "+description);
+		return it->second;
+	};
+	for (size_t i = 0; i < numbers.size(); i += numbers_per_node) {
+		adder_graph_node node;
+		int offset = node_output_shift ? 1 : 0;
+		node.value = numbers[i];
+		if (node_output_shift) node.post_adder_shift = (int)numbers[i+2];
+		auto first_value = numbers[i+offset+2];
+		auto first_shift = (int)numbers[i+offset+4];
+		auto second_value = numbers[i+offset+5];
+		auto second_shift = (int)numbers[i+offset+7];
+		// a negative second operand is a subtraction unless there is a node with that negative value
+		// (both interpretations compute the same value)
+		node.subtract = node_index.find(second_value) == node_index.end() ? 1 : 0;
+		if (node.subtract == 1) second_value = -second_value;
+		if (second_shift == 0) {
+			// (left << shift) +/- right
+			node.negate_select = 1;
+			node.left_input = get_node_index(first_value);
+			node.right_input = get_node_index(second_value);
+			node.shift = first_shift;
+		}
+		else {
+			// right +/- (left << shift)
+			node.negate_select = 0;
+			node.left_input = get_node_index(second_value);
+			node.right_input = get_node_index(first_value);
+			node.shift = second_shift;
+		}
+		node_index.emplace(node.value, (int)graph.size()+1);
+		graph.emplace_back(node);
+	}
+	return graph;
+}
@@ -0,0 +1,50 @@
+//
+// Created by nfiege on 11/16/22.
+//
+
+#ifndef SATSCM_ADDER_GRAPH_H
+#define SATSCM_ADDER_GRAPH_H
+
+#include <vector>
+#include <cstdint>
+#include <string>
+
+/*!
+ * one adder node in the same form that scm uses internally:
+ *   negate_select == 1: value = (left_input << shift) +/- right_input
+ *   negate_select == 0: value = right_input +/- (left_input << shift)
+ *   subtract == 1: the second operand is subtracted
+ * node 0 is the input node (value 1) and is not part of an adder graph vector
+ * i.e., the node at vector position i has index i+1 and may only use inputs with smaller indices
+ */
+struct adder_graph_node {
+	int left_input = 0;
+	int right_input = 0;
+	int shift = 0;
+	int negate_select = 1;
+	int subtract = 0;
+	int post_adder_shift = 0;
+	int64_t value = 1;
+};
+
+/*!
+ * build an adder graph for the given constants within milliseconds
+ * a target is added as soon as it can be computed with one adder from the existing nodes,
+ * otherwise the node that brings most targets into reach is added (Hcub/RAG-n style)
+ * and if no node helps, the next partial sum of the CSD (or binary) representation of the smallest target is added
+ * @param C odd positive constants (0 and 1 are ignored)
+ * @param max_bits all node values (and shifted inputs) must be smaller than 2^max_bits
+ * @param max_shift maximum left shift at the left adder input
+ * @return the adder graph (the last node computes C[0] if there is only one constant > 1)
+ */
+std::vector<adder_graph_node> create_heuristic_adder_graph(const std::vector<int> &C, int max_bits, int max_shift);
+
+/*!
+ * convert an adder graph in PAGSuite form (see scm::get_adder_graph_description) back to nodes
+ * @param description the adder graph
+ * @param node_output_shift whether the description contains post adder shifts
+ * @return the adder graph
+ */
+std::vector<adder_graph_node> parse_adder_graph_description(const std::string &description, bool node_output_shift);
+
+#endif //SATSCM_ADDER_GRAPH_H
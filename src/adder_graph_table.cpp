@@ -0,0 +1,109 @@
+//
+// Created by nfiege on 11/17/22.
+//
+
+#include "adder_graph_table.h"
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+static const char table_magic[8] = {'S', 'A', 'T', 'S', 'C', 'M', 'T', 'B'};
+
+adder_graph_table::adder_graph_table(const std::string &filename) {
+	int fd = open(filename.c_str(), O_RDONLY);
+	if (fd < 0) throw std::runtime_error("failed to open adder graph table "+filename);
+	struct stat file_stat;
+	if (fstat(fd, &file_stat) != 0 or file_stat.st_size < (off_t)sizeof(header)) {
+		close(fd);
+		throw std::runtime_error("invalid adder graph table "+filename);
+	}
+	this->size = file_stat.st_size;
+	auto mapping = mmap(nullptr, this->size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (mapping == MAP_FAILED) throw std::runtime_error("failed to map adder graph table "+filename);
+	this->data = (const char*)mapping;
+	// lookups only touch a few random pages
+	madvise(mapping, this->size, MADV_RANDOM);
+	this->table_header = (const header*)this->data;
+	this->index = (const index_entry*)(this->data + sizeof(header));
+	bool valid = std::memcmp(this->table_header->magic, table_magic, sizeof(table_magic)) == 0
+		and this->table_header->version == version
+		and this->table_header->max_bits >= 1 and this->table_header->max_bits <= 31;
+	if (valid) {
+		auto num_entries = ((uint64_t)1) << (this->table_header->max_bits-1);
+		valid = this->table_header->data_offset == sizeof(header) + num_entries * sizeof(index_entry)
+			and this->table_header->data_offset <= this->size;
+	}
+	if (!valid) {
+		munmap(mapping, this->size);
+		throw std::runtime_error("invalid adder graph table "+filename);
+	}
+}
+
+adder_graph_table::~adder_graph_table() {
+	munmap((void*)this->data, this->size);
+}
+
+int adder_graph_table::get_max_bits() const {
+	return (int)this->table_header->max_bits;
+}
+
+uint32_t adder_graph_table::get_flags() const {
+	return this->table_header->flags;
+}
+
+bool adder_graph_table::lookup(int64_t c, entry &e) const {
+	if (c < 1 or (c & 1) == 0 or c >= (((int64_t)1) << this->table_header->max_bits)) return false;
+	auto &it = this->index[(c-1)/2];
+	if ((it.status & entry_status::present) == 0) return false;
+	if (this->table_header->data_offset + it.offset + it.length > this->size) return false;
+	e.num_adders = it.num_adders;
+	e.adders_optimal = (it.status & entry_status::adders_optimal) != 0;
+	e.full_adders_optimal = (it.status & entry_status::full_adders_optimal) != 0;
+	e.graph.assign(this->data + this->table_header->data_offset + it.offset, it.length);
+	return true;
+}
+
+void adder_graph_table::write(const std::string &filename, int max_bits, uint32_t flags, const std::map<int64_t, entry> &entries) {
+	if (max_bits < 1 or max_bits > 31) throw std::runtime_error("adder graph tables support 1 to 31 bits");
+	auto num_entries = ((uint64_t)1) << (max_bits-1);
+	header h = {};
+	std::memcpy(h.magic, table_magic, sizeof(table_magic));
+	h.version = version;
+	h.max_bits = max_bits;
+	h.flags = flags;
+	h.data_offset = sizeof(header) + num_entries * sizeof(index_entry);
+	std::vector<index_entry> index(num_entries, {0, 0, 0, 0});
+	std::string graphs;
+	for (auto &it : entries) {
+		auto c = it.first;
+		auto &e = it.second;
+		if (c < 1 or (c & 1) == 0 or c >= (((int64_t)1) << max_bits)) continue;
+		if (e.graph.size() > std::numeric_limits<uint16_t>::max() or e.num_adders > std::numeric_limits<uint8_t>::max()) {
+			throw std::runtime_error("adder graph for constant "+std::to_string(c)+" is too large for the table");
+		}
+		if (graphs.size() + e.graph.size() > std::numeric_limits<uint32_t>::max()) {
+			throw std::runtime_error("adder graph table exceeds 4 GiB");
+		}
+		auto &i = index[(c-1)/2];
+		i.offset = (uint32_t)graphs.size();
+		i.length = (uint16_t)e.graph.size();
+		i.num_adders = (uint8_t)e.num_adders;
+		i.status = entry_status::present;
+		if (e.adders_optimal) i.status |= entry_status::adders_optimal;
+		if (e.full_adders_optimal) i.status |= entry_status::full_adders_optimal;
+		graphs += e.graph;
+	}
+	std::ofstream f(filename, std::ios::binary | std::ios::trunc);
+	if (!f) throw std::runtime_error("failed to create adder graph table "+filename);
+	f.write((const char*)&h, sizeof(h));
+	f.write((const char*)index.data(), index.size() * sizeof(index_entry));
+	f.write(graphs.data(), graphs.size());
+	if (!f) throw std::runtime_error("failed to write adder graph table "+filename);
+}
@@ -0,0 +1,99 @@
+//
+// Created by nfiege on 11/17/22.
+//
+
+#ifndef SATSCM_ADDER_GRAPH_TABLE_H
+#define SATSCM_ADDER_GRAPH_TABLE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <map>
+#include <string>
+
+/*!
+ * read-only table with precomputed adder graphs for all odd constants up to a fixed bit width
+ * the file is memory-mapped so a lookup only touches the pages of one index entry and one graph
+ * file layout (native byte order):
+ *   -> header (see adder_graph_table::header)
+ *   -> index with one fixed-size entry for each odd constant c < 2^max_bits at position (c-1)/2
+ *   -> graph descriptions in PAGSuite form (see scm::get_adder_graph_description) without terminating 0
+ */
+class adder_graph_table {
+public:
+	/*!
+	 * solver settings that were used to generate the table
+	 */
+	enum table_flags : uint32_t {
+		minimize_full_adders = 1,
+		node_output_shift = 2,
+		negative_numbers = 4
+	};
+	struct entry {
+		int num_adders = 0;
+		bool adders_optimal = false;
+		bool full_adders_optimal = false;
+		std::string graph;
+	};
+	/*!
+	 * memory-map a table file
+	 * @param filename path to a file that was created by adder_graph_table::write
+	 */
+	explicit adder_graph_table(const std::string &filename);
+	~adder_graph_table();
+	adder_graph_table(const adder_graph_table &) = delete;
+	adder_graph_table &operator=(const adder_graph_table &) = delete;
+	/*!
+	 * @return all odd constants < 2^max_bits are in the table
+	 */
+	int get_max_bits() const;
+	/*!
+	 * @return the table_flags the table was generated with
+	 */
+	uint32_t get_flags() const;
+	/*!
+	 * look up the adder graph for an odd positive constant
+	 * @param c the constant
+	 * @param e is filled if the constant is in the table
+	 * @return whether the constant is in the table
+	 */
+	bool lookup(int64_t c, entry &e) const;
+	/*!
+	 * create a table file
+	 * @param filename path to the file
+	 * @param max_bits all odd constants < 2^max_bits get an index entry
+	 * @param flags the table_flags the entries were generated with
+	 * @param entries all known graphs (constants that are missing here are marked as unknown)
+	 */
+	static void write(const std::string &filename, int max_bits, uint32_t flags, const std::map<int64_t, entry> &entries);
+
+private:
+	struct header {
+		char magic[8];
+		uint32_t version;
+		uint32_t max_bits;
+		uint32_t flags;
+		uint32_t reserved;
+		uint64_t data_offset;
+	};
+	struct index_entry {
+		uint32_t offset;
+		uint16_t length;
+		uint8_t num_adders;
+		uint8_t status;
+	};
+	enum entry_status : uint8_t {
+		present = 1,
+		adders_optimal = 2,
+		full_adders_optimal = 4
+	};
+	static constexpr uint32_t version = 1;
+	/*!
+	 * start and size of the memory-mapped file
+	 */
+	const char *data = nullptr;
+	std::size_t size = 0;
+	const header *table_header = nullptr;
+	const index_entry *index = nullptr;
+};
+
+#endif //SATSCM_ADDER_GRAPH_TABLE_H
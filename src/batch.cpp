@@ -0,0 +1,113 @@
+//
+// Created by nfiege on 11/19/22.
+//
+
+#include "batch.h"
+#include <work_stealing_pool.h>
+#include <json_record.h>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+int solve_batch(std::istream &input, std::ostream &output, int jobs, int timeout,
+	const std::function<std::unique_ptr<scm>(const std::vector<int> &C, int timeout)> &create_solver) {
+	std::mutex output_mutex;
+	auto write_record = [&](const std::string &record) {
+		std::lock_guard<std::mutex> lock(output_mutex);
+		output << record << std::endl;
+	};
+	// running problems with their deadlines
+	std::mutex running_mutex;
+	std::map<int, std::pair<std::chrono::steady_clock::time_point, scm*>> running;
+	std::atomic<bool> stop_watchdog = false;
+	std::thread watchdog([&]() {
+		while (!stop_watchdog) {
+			{
+				std::lock_guard<std::mutex> lock(running_mutex);
+				auto now = std::chrono::steady_clock::now();
+				for (auto &it : running) {
+					// repeat this until the problem is done because the solver might not have started solving yet
+					if (now >= it.second.first) it.second.second->interrupt();
+				}
+			}
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		}
+	});
+	std::atomic<int> num_solved = 0;
+	{
+		work_stealing_pool pool(jobs);
+		std::string line;
+		int id = 0;
+		while (std::getline(input, line)) {
+			std::stringstream line_stream(line);
+			std::string constants;
+			if (!(line_stream >> constants) or constants[0] == '#') continue;
+			auto problem_id = id++;
+			std::vector<int> C;
+			int problem_timeout = timeout;
+			try {
+				std::stringstream c_str(constants);
+				std::string buff;
+				while(std::getline(c_str, buff, ':')) {
+					C.emplace_back(std::stoi(buff));
+				}
+				std::string t;
+				if (line_stream >> t) problem_timeout = std::stoi(t);
+			}
+			catch (...) {
+				write_record("{\"id\":" + std::to_string(problem_id) + ",\"status\":\"error\",\"message\":" + json_string("failed to parse '"+line+"'") + "}");
+				continue;
+			}
+			pool.submit([&, problem_id, C, problem_timeout]() {
+				auto start_time = std::chrono::steady_clock::now();
+				std::stringstream record;
+				record << "{\"id\":" << problem_id << ",\"constants\":" << json_array(C);
+				try {
+					auto solver = create_solver(C, problem_timeout);
+					// the timeout of a problem limits the whole run -> let the solver split it between its phases
+					solver->set_time_budget(problem_timeout);
+					{
+						std::lock_guard<std::mutex> lock(running_mutex);
+						running[problem_id] = {start_time + std::chrono::seconds(problem_timeout), solver.get()};
+					}
+					try {
+						solver->solve();
+					}
+					catch (...) {
+						std::lock_guard<std::mutex> lock(running_mutex);
+						running.erase(problem_id);
+						throw;
+					}
+					{
+						std::lock_guard<std::mutex> lock(running_mutex);
+						running.erase(problem_id);
+					}
+					auto graph = solver->get_adder_graph_description();
+					if (graph.empty()) {
+						record << ",\"status\":\"no_solution\"";
+					}
+					else {
+						record << ",\"status\":\"solved\"";
+						write_solution_fields(record, *solver, true);
+						num_solved++;
+					}
+				}
+				catch (std::exception &e) {
+					record << ",\"status\":\"error\",\"message\":" << json_string(e.what());
+				}
+				auto elapsed_time = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_time).count() / 1000.0;
+				record << ",\"time\":" << elapsed_time << "}";
+				write_record(record.str());
+			});
+		}
+		pool.wait();
+	}
+	stop_watchdog = true;
+	watchdog.join();
+	return num_solved;
+}
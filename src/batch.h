@@ -0,0 +1,33 @@
+//
+// Created by nfiege on 11/19/22.
+//
+
+#ifndef SATSCM_BATCH_H
+#define SATSCM_BATCH_H
+
+#include <scm.h>
+#include <functional>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <vector>
+
+/*!
+ * solve many independent problems on a work-stealing thread pool (one scm instance per problem)
+ * input: one problem per line in the form <int:int:...> [timeout in seconds]
+ *   -> empty lines and lines starting with '#' are skipped
+ *   -> the optional timeout overrides the default timeout for this problem
+ * the timeout is a wall-clock budget for the whole problem, the solver is interrupted when it is used up
+ * and reports the best solution it found so far
+ * output: one JSON record per line and problem as soon as the problem is solved (in completion order)
+ * @param input the problems
+ * @param output the result records
+ * @param jobs number of problems that are solved in parallel
+ * @param timeout default timeout in seconds
+ * @param create_solver creates a configured solver for the given constants and timeout
+ * @return number of problems that were solved
+ */
+int solve_batch(std::istream &input, std::ostream &output, int jobs, int timeout,
+	const std::function<std::unique_ptr<scm>(const std::vector<int> &C, int timeout)> &create_solver);
+
+#endif //SATSCM_BATCH_H
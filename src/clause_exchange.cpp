@@ -0,0 +1,69 @@
+//
+// Created by nfiege on 12/1/22.
+//
+
+#include "clause_exchange.h"
+#include <algorithm>
+
+clause_exchange::clause_exchange(int max_clause_size, size_t capacity)
+	: max_clause_size(max_clause_size), capacity(std::max((size_t)1, capacity)),
+	slots(new slot[this->capacity]), literals(new std::atomic<int>[this->capacity * max_clause_size]()) {}
+
+int clause_exchange::join() {
+	return this->num_participants++;
+}
+
+int clause_exchange::get_max_clause_size() const {
+	return this->max_clause_size;
+}
+
+void clause_exchange::export_clause(int participant, const int *literals, int size) {
+	if (size <= 0 or size > this->max_clause_size) return;
+	auto position = this->write_position.fetch_add(1, std::memory_order_relaxed);
+	auto &s = this->slots[position % this->capacity];
+	// only one writer per slot -> drop the clause if a writer that is a whole round behind still uses it
+	auto sequence = s.sequence.load(std::memory_order_relaxed);
+	if ((sequence & 1) != 0 or !s.sequence.compare_exchange_strong(sequence, 2*position+1, std::memory_order_acquire)) return;
+	std::atomic_thread_fence(std::memory_order_release);
+	s.participant.store(participant, std::memory_order_relaxed);
+	s.size.store(size, std::memory_order_relaxed);
+	auto slot_literals = this->literals.get() + (position % this->capacity) * this->max_clause_size;
+	for (int i = 0; i < size; i++) {
+		slot_literals[i].store(literals[i], std::memory_order_relaxed);
+	}
+	s.sequence.store(2*position+2, std::memory_order_release);
+}
+
+size_t clause_exchange::import_clauses(int participant, uint64_t &position, std::vector<int> &clauses, size_t max_clauses) const {
+	auto end = this->write_position.load(std::memory_order_acquire);
+	// older clauses are overwritten already or we skip them because there are too many
+	auto start = std::max(position, end - std::min<uint64_t>(end, std::min(this->capacity, max_clauses)));
+	size_t num_imported = 0;
+	std::vector<int> clause(this->max_clause_size);
+	for (auto p = start; p < end; p++) {
+		auto &s = this->slots[p % this->capacity];
+		auto sequence = s.sequence.load(std::memory_order_acquire);
+		// the clause is not written completely yet or it was overwritten already -> skip it
+		if (sequence != 2*p+2) continue;
+		auto owner = s.participant.load(std::memory_order_relaxed);
+		auto size = std::min(s.size.load(std::memory_order_relaxed), this->max_clause_size);
+		auto slot_literals = this->literals.get() + (p % this->capacity) * this->max_clause_size;
+		for (int i = 0; i < size; i++) {
+			clause[i] = slot_literals[i].load(std::memory_order_relaxed);
+		}
+		// the copy is only consistent if nobody started to overwrite the slot in the meantime
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (s.sequence.load(std::memory_order_relaxed) != sequence) continue;
+		if (owner == participant) continue;
+		clauses.insert(clauses.end(), clause.begin(), clause.begin()+size);
+		clauses.emplace_back(0);
+		num_imported++;
+	}
+	position = end;
+	return num_imported;
+}
+
+uint64_t clause_exchange::num_pending(uint64_t position) const {
+	auto end = this->write_position.load(std::memory_order_relaxed);
+	return end > position ? end - position : 0;
+}
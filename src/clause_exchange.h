@@ -0,0 +1,83 @@
+//
+// Created by nfiege on 12/1/22.
+//
+
+#ifndef SATSCM_CLAUSE_EXCHANGE_H
+#define SATSCM_CLAUSE_EXCHANGE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/*!
+ * lock-free ring buffer that distributes short learned clauses between solver instances
+ * all participants must solve exactly the same problem (same clauses and variable indices)
+ * because the clauses are only implied by the problem they were learned from
+ * sharing is best effort: clauses that are overwritten before a participant reads them are lost
+ */
+class clause_exchange {
+public:
+	/*!
+	 * constructor
+	 * @param max_clause_size longer clauses are not exported
+	 * @param capacity number of clauses that the buffer holds before it overwrites the oldest ones
+	 */
+	explicit clause_exchange(int max_clause_size = 8, size_t capacity = 1 << 15);
+	/*!
+	 * @return a new participant id (used to skip the own clauses when importing)
+	 */
+	int join();
+	/*!
+	 * @return the longest clause that is exported
+	 */
+	int get_max_clause_size() const;
+	/*!
+	 * publish a clause (thread-safe, the clause is dropped if it is too long)
+	 * @param participant id of the exporting participant
+	 * @param literals DIMACS literals without the terminating 0
+	 * @param size number of literals
+	 */
+	void export_clause(int participant, const int *literals, int size);
+	/*!
+	 * collect the clauses of all other participants that were published since the last call (thread-safe)
+	 * only the newest max_clauses clauses are considered so that a slow participant is not swamped
+	 * @param participant id of the importing participant
+	 * @param position read position of the participant (starts at 0 and is updated by this function)
+	 * @param clauses the clauses are appended in DIMACS format (each clause is terminated by 0)
+	 * @param max_clauses
+	 * @return the number of appended clauses
+	 */
+	size_t import_clauses(int participant, uint64_t &position, std::vector<int> &clauses, size_t max_clauses) const;
+	/*!
+	 * @param position read position of a participant
+	 * @return number of clauses (including the own ones) that were published since then
+	 */
+	uint64_t num_pending(uint64_t position) const;
+
+private:
+	struct slot {
+		/*!
+		 * 2*position+2 after the clause with this position was written completely
+		 * odd while a clause is being written
+		 */
+		std::atomic<uint64_t> sequence = 0;
+		std::atomic<int> participant = -1;
+		std::atomic<int> size = 0;
+	};
+	int max_clause_size;
+	size_t capacity;
+	std::unique_ptr<slot[]> slots;
+	/*!
+	 * capacity*max_clause_size literals (atomic because readers may copy a slot while it is overwritten)
+	 */
+	std::unique_ptr<std::atomic<int>[]> literals;
+	/*!
+	 * position of the next clause
+	 */
+	std::atomic<uint64_t> write_position = 0;
+	std::atomic<int> num_participants = 0;
+};
+
+#endif //SATSCM_CLAUSE_EXCHANGE_H
@@ -0,0 +1,173 @@
+//
+// Created by nfiege on 11/23/22.
+//
+
+#include "cnf_reader.h"
+#include <cnf_writer.h>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <fcntl.h>
+#include <unistd.h>
+#ifdef USE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef USE_LZMA
+#include <lzma.h>
+#endif
+
+/*!
+ * @return the decompressed content of the file
+ */
+static std::string read_content(const std::string &filename, cnf_writer::compression comp) {
+	std::string content;
+	char buffer[1 << 16];
+	switch (comp) {
+		case cnf_writer::compression::no_compression: {
+			int fd = open(filename.c_str(), O_RDONLY);
+			if (fd < 0) throw std::runtime_error("failed to open "+filename);
+			while (true) {
+				auto num_read = read(fd, buffer, sizeof(buffer));
+				if (num_read < 0 and errno == EINTR) continue;
+				if (num_read < 0) {
+					close(fd);
+					throw std::runtime_error(std::string("failed to read "+filename+": ")+std::strerror(errno));
+				}
+				if (num_read == 0) break;
+				content.append(buffer, num_read);
+			}
+			close(fd);
+			break;
+		}
+		case cnf_writer::compression::gzip: {
+#ifdef USE_ZLIB
+			// gzread continues with the next stream if the file consists of several ones
+			auto f = gzopen(filename.c_str(), "rb");
+			if (f == nullptr) throw std::runtime_error("failed to open "+filename);
+			int num_read;
+			while ((num_read = gzread(f, buffer, sizeof(buffer))) > 0) {
+				content.append(buffer, num_read);
+			}
+			gzclose(f);
+			if (num_read < 0) throw std::runtime_error("failed to decompress "+filename);
+#endif
+			break;
+		}
+		case cnf_writer::compression::xz: {
+#ifdef USE_LZMA
+			auto compressed = read_content(filename, cnf_writer::compression::no_compression);
+			lzma_stream lz = LZMA_STREAM_INIT;
+			if (lzma_stream_decoder(&lz, UINT64_MAX, LZMA_CONCATENATED) != LZMA_OK) throw std::runtime_error("failed to initialize liblzma");
+			lz.next_in = (const uint8_t*)compressed.data();
+			lz.avail_in = compressed.size();
+			lzma_ret ret;
+			do {
+				lz.next_out = (uint8_t*)buffer;
+				lz.avail_out = sizeof(buffer);
+				ret = lzma_code(&lz, LZMA_FINISH);
+				content.append(buffer, sizeof(buffer) - lz.avail_out);
+			} while (ret == LZMA_OK);
+			lzma_end(&lz);
+			if (ret != LZMA_STREAM_END) throw std::runtime_error("failed to decompress "+filename);
+#endif
+			break;
+		}
+	}
+	return content;
+}
+
+std::string cnf_reader::strip_extension(const std::string &filename) {
+	auto base = filename;
+	for (auto &suffix : {".gz", ".xz"}) {
+		auto len = std::strlen(suffix);
+		if (base.size() > len and base.compare(base.size()-len, len, suffix) == 0) {
+			base.resize(base.size()-len);
+			break;
+		}
+	}
+	for (auto &suffix : {".bcnf", ".cnf"}) {
+		auto len = std::strlen(suffix);
+		if (base.size() > len and base.compare(base.size()-len, len, suffix) == 0) {
+			return base.substr(0, base.size()-len);
+		}
+	}
+	return "";
+}
+
+void cnf_reader::read_file(const std::string &filename, int &num_variables, std::vector<int> &clauses) {
+	auto base = strip_extension(filename);
+	if (base.empty()) throw std::runtime_error("unknown CNF format of "+filename);
+	auto f = cnf_writer::parse_format(filename.substr(base.size()+1));
+	auto content = read_content(filename, f.comp);
+	// skip comments and parse the header
+	size_t pos = 0;
+	long long num_clauses = -1;
+	while (pos < content.size()) {
+		auto line_end = content.find('\n', pos);
+		if (line_end == std::string::npos) line_end = content.size();
+		auto line = content.substr(pos, line_end-pos);
+		pos = line_end+1;
+		if (line.empty() or line[0] == 'c') continue;
+		std::stringstream header(line);
+		std::string p, cnf;
+		if (!(header >> p >> cnf >> num_variables >> num_clauses) or p != "p" or cnf != "cnf") throw std::runtime_error("invalid CNF header in "+filename);
+		break;
+	}
+	if (num_clauses < 0) throw std::runtime_error("missing CNF header in "+filename);
+	clauses.clear();
+	clauses.reserve(content.size() / (f.enc == cnf_writer::encoding::binary ? 2 : 4));
+	long long clause_count = 0;
+	if (f.enc == cnf_writer::encoding::binary) {
+		while (pos < content.size()) {
+			unsigned int x = 0;
+			int shift = 0;
+			unsigned char byte;
+			do {
+				if (pos >= content.size() or shift > 28) throw std::runtime_error("truncated binary CNF "+filename);
+				byte = (unsigned char)content[pos++];
+				x |= (unsigned int)(byte & 127) << shift;
+				shift += 7;
+			} while (byte & 128);
+			if (x == 0) {
+				clauses.emplace_back(0);
+				clause_count++;
+			}
+			else {
+				clauses.emplace_back((x & 1) ? -(int)(x >> 1) : (int)(x >> 1));
+			}
+		}
+	}
+	else {
+		const char *p = content.data() + pos;
+		const char *end = content.data() + content.size();
+		while (p < end) {
+			if (*p == 'c') {
+				// comment line
+				while (p < end and *p != '\n') p++;
+				continue;
+			}
+			if (*p == ' ' or *p == '\n' or *p == '\t' or *p == '\r') {
+				p++;
+				continue;
+			}
+			bool negative = *p == '-';
+			if (negative) p++;
+			if (p >= end or *p < '0' or *p > '9') throw std::runtime_error("invalid literal in "+filename);
+			int lit = 0;
+			while (p < end and *p >= '0' and *p <= '9') {
+				lit = 10 * lit + (*p - '0');
+				p++;
+			}
+			clauses.emplace_back(negative ? -lit : lit);
+			if (lit == 0) clause_count++;
+		}
+	}
+	if (!clauses.empty() and clauses.back() != 0) throw std::runtime_error("last clause in "+filename+" is not terminated");
+	if (clause_count != num_clauses) throw std::runtime_error("expected "+std::to_string(num_clauses)+" clauses in "+filename+" but found "+std::to_string(clause_count));
+	for (auto &lit : clauses) {
+		if (std::abs(lit) > num_variables) throw std::runtime_error("variable "+std::to_string(std::abs(lit))+" in "+filename+" exceeds the number of variables");
+	}
+}
@@ -0,0 +1,30 @@
+//
+// Created by nfiege on 11/23/22.
+//
+
+#ifndef SATSCM_CNF_READER_H
+#define SATSCM_CNF_READER_H
+
+#include <string>
+#include <vector>
+
+/*!
+ * reads CNF files in all formats that cnf_writer supports (the format is selected by the file extension)
+ */
+class cnf_reader {
+public:
+	/*!
+	 * @param filename
+	 * @param num_variables the number of variables from the header
+	 * @param clauses all clauses in DIMACS format, i.e., the literals of each clause are terminated by 0
+	 * throws if the file can't be read or is malformed
+	 */
+	static void read_file(const std::string &filename, int &num_variables, std::vector<int> &clauses);
+	/*!
+	 * @param filename
+	 * @return filename without the CNF extension (e.g., 7_11-2-5 for 7_11-2-5.cnf.gz) or an empty string if it has none
+	 */
+	static std::string strip_extension(const std::string &filename);
+};
+
+#endif //SATSCM_CNF_READER_H
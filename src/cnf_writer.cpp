@@ -0,0 +1,259 @@
+//
+// Created by nfiege on 11/22/22.
+//
+
+#include "cnf_writer.h"
+#include <cerrno>
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+#include <fcntl.h>
+#include <unistd.h>
+#ifdef USE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef USE_LZMA
+#include <lzma.h>
+#endif
+
+/*!
+ * write the whole buffer to fd
+ */
+static void write_all(int fd, const char *data, size_t size) {
+	while (size > 0) {
+		auto written = ::write(fd, data, size);
+		if (written < 0) {
+			if (errno == EINTR) continue;
+			throw std::runtime_error(std::string("failed to write CNF file: ")+std::strerror(errno));
+		}
+		data += written;
+		size -= written;
+	}
+}
+
+/*!
+ * writes one (possibly compressed) stream to a file descriptor
+ */
+class stream_compressor {
+public:
+	stream_compressor(cnf_writer::compression comp, int fd) : comp(comp), fd(fd) {
+		switch (this->comp) {
+			case cnf_writer::compression::no_compression: break;
+			case cnf_writer::compression::gzip: {
+#ifdef USE_ZLIB
+				// 15+16 -> gzip header instead of zlib header
+				if (deflateInit2(&this->gz, 6, Z_DEFLATED, 15+16, 8, Z_DEFAULT_STRATEGY) != Z_OK) throw std::runtime_error("failed to initialize zlib");
+#endif
+				break;
+			}
+			case cnf_writer::compression::xz: {
+#ifdef USE_LZMA
+				if (lzma_easy_encoder(&this->lz, 3, LZMA_CHECK_CRC64) != LZMA_OK) throw std::runtime_error("failed to initialize liblzma");
+#endif
+				break;
+			}
+		}
+	}
+	~stream_compressor() {
+#ifdef USE_ZLIB
+		if (this->comp == cnf_writer::compression::gzip) deflateEnd(&this->gz);
+#endif
+#ifdef USE_LZMA
+		if (this->comp == cnf_writer::compression::xz) lzma_end(&this->lz);
+#endif
+	}
+	stream_compressor(const stream_compressor &) = delete;
+	stream_compressor &operator=(const stream_compressor &) = delete;
+	void write(const std::string &data) {
+		this->process(data.data(), data.size(), false);
+	}
+	/*!
+	 * terminate the stream (the compressor can't be used afterwards)
+	 */
+	void finish() {
+		this->process(nullptr, 0, true);
+	}
+
+private:
+	cnf_writer::compression comp;
+	int fd;
+	char out[1 << 16];
+#ifdef USE_ZLIB
+	z_stream gz{};
+#endif
+#ifdef USE_LZMA
+	lzma_stream lz = LZMA_STREAM_INIT;
+#endif
+	void process(const char *data, size_t size, bool finish) {
+		// finish is only needed by the compressors
+		(void) finish;
+		switch (this->comp) {
+			case cnf_writer::compression::no_compression: {
+				write_all(this->fd, data, size);
+				break;
+			}
+			case cnf_writer::compression::gzip: {
+#ifdef USE_ZLIB
+				this->gz.next_in = (Bytef*)data;
+				this->gz.avail_in = (uInt)size;
+				int ret;
+				do {
+					this->gz.next_out = (Bytef*)this->out;
+					this->gz.avail_out = sizeof(this->out);
+					ret = deflate(&this->gz, finish ? Z_FINISH : Z_NO_FLUSH);
+					if (ret == Z_STREAM_ERROR) throw std::runtime_error("zlib failed to compress CNF file");
+					write_all(this->fd, this->out, sizeof(this->out) - this->gz.avail_out);
+				} while (this->gz.avail_out == 0 or (finish and ret != Z_STREAM_END));
+#endif
+				break;
+			}
+			case cnf_writer::compression::xz: {
+#ifdef USE_LZMA
+				this->lz.next_in = (const uint8_t*)data;
+				this->lz.avail_in = size;
+				lzma_ret ret;
+				do {
+					this->lz.next_out = (uint8_t*)this->out;
+					this->lz.avail_out = sizeof(this->out);
+					ret = lzma_code(&this->lz, finish ? LZMA_FINISH : LZMA_RUN);
+					if (ret != LZMA_OK and ret != LZMA_STREAM_END) throw std::runtime_error("liblzma failed to compress CNF file");
+					write_all(this->fd, this->out, sizeof(this->out) - this->lz.avail_out);
+				} while (this->lz.avail_out == 0 or (finish and ret != LZMA_STREAM_END));
+#endif
+				break;
+			}
+		}
+	}
+};
+
+cnf_writer::format cnf_writer::parse_format(const std::string &extension) {
+	format result;
+	auto base = extension;
+	auto dot = extension.find('.');
+	if (dot != std::string::npos) {
+		base = extension.substr(0, dot);
+		auto suffix = extension.substr(dot+1);
+		if (suffix == "gz") {
+#ifndef USE_ZLIB
+			throw std::runtime_error("satscm was built without zlib -> can't write "+extension+" files");
+#endif
+			result.comp = compression::gzip;
+		}
+		else if (suffix == "xz") {
+#ifndef USE_LZMA
+			throw std::runtime_error("satscm was built without liblzma -> can't write "+extension+" files");
+#endif
+			result.comp = compression::xz;
+		}
+		else throw std::runtime_error("unknown CNF compression "+suffix);
+	}
+	if (base == "cnf") result.enc = encoding::text;
+	else if (base == "bcnf") result.enc = encoding::binary;
+	else throw std::runtime_error("unknown CNF format "+extension);
+	return result;
+}
+
+std::string cnf_writer::get_extension(const format &f) {
+	std::string result = f.enc == encoding::binary ? "bcnf" : "cnf";
+	if (f.comp == compression::gzip) result += ".gz";
+	else if (f.comp == compression::xz) result += ".xz";
+	return result;
+}
+
+cnf_writer::cnf_writer(const format &f) : f(f) {
+	auto spool_filename = (std::filesystem::temp_directory_path() / "satscm_cnf_XXXXXX").string();
+	this->spool_fd = mkstemp(spool_filename.data());
+	if (this->spool_fd < 0) throw std::runtime_error("failed to create CNF spool file "+spool_filename);
+	// the file is deleted as soon as it is closed (even if we crash)
+	unlink(spool_filename.c_str());
+	this->buffer.reserve(1 << 20);
+}
+
+cnf_writer::~cnf_writer() {
+	// destroy the compressor before its file descriptor is closed
+	this->spool_stream.reset();
+	if (this->spool_fd >= 0) close(this->spool_fd);
+}
+
+void cnf_writer::encode_clause(std::string &buff, const int *literals, int num_literals) const {
+	if (this->f.enc == encoding::binary) {
+		for (int i = 0; i <= num_literals; i++) {
+			// the 0 at the end terminates the clause
+			unsigned int x = i < num_literals ? 2 * (unsigned int)std::abs(literals[i]) + (literals[i] < 0 ? 1 : 0) : 0;
+			while (x > 127) {
+				buff.push_back((char)(128 | (x & 127)));
+				x >>= 7;
+			}
+			buff.push_back((char)x);
+		}
+		return;
+	}
+	char number[16];
+	for (int i = 0; i < num_literals; i++) {
+		auto end = std::to_chars(number, number + sizeof(number), literals[i]).ptr;
+		buff.append(number, end);
+		buff.push_back(' ');
+	}
+	buff.append(" 0\n");
+}
+
+void cnf_writer::add_clause(const int *literals, int num_literals) {
+	this->encode_clause(this->buffer, literals, num_literals);
+	this->num_clauses++;
+	if (this->buffer.size() >= (1 << 20)) this->flush_buffer();
+}
+
+void cnf_writer::flush_buffer() {
+	if (this->buffer.empty()) return;
+	if (this->spool_stream == nullptr) this->spool_stream = std::make_unique<stream_compressor>(this->f.comp, this->spool_fd);
+	this->spool_stream->write(this->buffer);
+	this->buffer.clear();
+}
+
+void cnf_writer::write_file(const std::string &filename, int num_variables, const std::vector<int> &unit_literals) {
+	// complete the current stream of the spool file so that it can be copied
+	// -> following clauses go into a new stream
+	this->flush_buffer();
+	if (this->spool_stream != nullptr) {
+		this->spool_stream->finish();
+		this->spool_stream.reset();
+	}
+	int fd = open(filename.c_str(), O_CREAT | O_TRUNC | O_WRONLY, 0644);
+	if (fd < 0) throw std::runtime_error("failed to open "+filename);
+	try {
+		{
+			stream_compressor head_stream(this->f.comp, fd);
+			head_stream.write("p cnf " + std::to_string(num_variables) + " " + std::to_string(this->num_clauses + (long long)unit_literals.size()) + "\n");
+			head_stream.finish();
+		}
+		// copy the spool file
+		char copy_buffer[1 << 16];
+		off_t offset = 0;
+		while (true) {
+			auto num_read = pread(this->spool_fd, copy_buffer, sizeof(copy_buffer), offset);
+			if (num_read < 0) {
+				if (errno == EINTR) continue;
+				throw std::runtime_error(std::string("failed to read CNF spool file: ")+std::strerror(errno));
+			}
+			if (num_read == 0) break;
+			write_all(fd, copy_buffer, num_read);
+			offset += num_read;
+		}
+		if (!unit_literals.empty()) {
+			std::string units;
+			for (auto &lit : unit_literals) {
+				this->encode_clause(units, &lit, 1);
+			}
+			stream_compressor unit_stream(this->f.comp, fd);
+			unit_stream.write(units);
+			unit_stream.finish();
+		}
+	}
+	catch (...) {
+		close(fd);
+		throw;
+	}
+	if (close(fd) != 0) throw std::runtime_error("failed to write "+filename);
+}
@@ -0,0 +1,98 @@
+//
+// Created by nfiege on 11/22/22.
+//
+
+#ifndef SATSCM_CNF_WRITER_H
+#define SATSCM_CNF_WRITER_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+class stream_compressor;
+
+/*!
+ * writes the clauses of a SAT problem to CNF files without keeping them in memory
+ * the clauses are streamed into an anonymous spool file as soon as they are created
+ * and each CNF file consists of the header, a copy of the spool file and the unit clauses passed to this->write_file
+ * -> several CNF files can be written for a growing problem (incremental solving)
+ * supported formats (selected by the file extension):
+ *   -> cnf: DIMACS text format
+ *   -> bcnf: "p cnf <#variables> <#clauses>" line followed by the clauses in binary DRAT encoding,
+ *      i.e., each literal l is stored as variable-length integer 2*|l| + (l < 0 ? 1 : 0) (7 bits per byte, LSB first)
+ *      and each clause is terminated by a 0 byte
+ *   -> cnf.gz / bcnf.gz / cnf.xz / bcnf.xz: compressed versions (if satscm was built with zlib / liblzma)
+ * compressed files consist of several concatenated gzip/xz streams which gzip and xz decompress as one file
+ */
+class cnf_writer {
+public:
+	enum encoding {
+		text, binary
+	};
+	enum compression {
+		no_compression, gzip, xz
+	};
+	struct format {
+		encoding enc = encoding::text;
+		compression comp = compression::no_compression;
+	};
+	/*!
+	 * @param extension cnf, bcnf, cnf.gz, bcnf.gz, cnf.xz or bcnf.xz
+	 * @return the corresponding format (throws if the extension is unknown or the compression is not supported by this build)
+	 */
+	static format parse_format(const std::string &extension);
+	/*!
+	 * @return the file extension for the given format (without leading dot)
+	 */
+	static std::string get_extension(const format &f);
+	/*!
+	 * create the spool file
+	 * @param f output format of all files written by this instance
+	 */
+	explicit cnf_writer(const format &f);
+	~cnf_writer();
+	cnf_writer(const cnf_writer &) = delete;
+	cnf_writer &operator=(const cnf_writer &) = delete;
+	/*!
+	 * append a clause
+	 * @param literals DIMACS literals without the terminating 0
+	 * @param num_literals
+	 */
+	void add_clause(const int *literals, int num_literals);
+	/*!
+	 * write all clauses added so far to a CNF file
+	 * @param filename
+	 * @param num_variables
+	 * @param unit_literals additional unit clauses that only go into this file (e.g., assumptions)
+	 */
+	void write_file(const std::string &filename, int num_variables, const std::vector<int> &unit_literals);
+
+private:
+	format f;
+	/*!
+	 * file descriptor of the spool file (it is unlinked right after creation)
+	 */
+	int spool_fd = -1;
+	/*!
+	 * number of clauses in the spool file
+	 */
+	long long num_clauses = 0;
+	/*!
+	 * clauses that have not been passed to the compressor yet
+	 */
+	std::string buffer;
+	/*!
+	 * compresses the current stream of the spool file (nullptr if no stream is open)
+	 */
+	std::unique_ptr<stream_compressor> spool_stream;
+	/*!
+	 * append a clause to buff in this->f.enc
+	 */
+	void encode_clause(std::string &buff, const int *literals, int num_literals) const;
+	/*!
+	 * pass this->buffer to the spool stream
+	 */
+	void flush_buffer();
+};
+
+#endif //SATSCM_CNF_WRITER_H
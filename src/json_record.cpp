@@ -0,0 +1,47 @@
+//
+// Created by nfiege on 11/29/22.
+//
+
+#include "json_record.h"
+#include <sstream>
+
+std::string json_string(const std::string &s) {
+	std::stringstream result;
+	result << '"';
+	for (auto &c : s) {
+		switch (c) {
+			case '"': result << "\\\""; break;
+			case '\\': result << "\\\\"; break;
+			case '\n': result << "\\n"; break;
+			case '\t': result << "\\t"; break;
+			default: result << c;
+		}
+	}
+	result << '"';
+	return result.str();
+}
+
+std::string json_array(const std::vector<int> &C) {
+	std::stringstream result;
+	result << "[";
+	for (size_t i = 0; i < C.size(); i++) {
+		result << (i > 0 ? "," : "") << C[i];
+	}
+	result << "]";
+	return result.str();
+}
+
+void write_solution_fields(std::ostream &record, scm &solver, bool final) {
+	auto [add_opt, fa_opt] = solver.solution_is_optimal();
+	auto [adder_lower, adders] = solver.get_adder_bounds();
+	record << ",\"adders\":" << adders;
+	if (final) record << ",\"adders_optimal\":" << (add_opt ? "true" : "false");
+	record << ",\"adder_lower_bound\":" << adder_lower;
+	auto [lower, upper] = solver.get_full_adder_bounds();
+	if (upper != FULL_ADDERS_UNLIMITED) {
+		record << ",\"full_adders\":" << upper;
+		record << ",\"full_adder_lower_bound\":" << lower;
+		if (final) record << ",\"full_adders_optimal\":" << (fa_opt ? "true" : "false");
+	}
+	record << ",\"graph\":" << json_string(solver.get_adder_graph_description());
+}
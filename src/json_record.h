@@ -0,0 +1,34 @@
+//
+// Created by nfiege on 11/29/22.
+//
+
+#ifndef SATSCM_JSON_RECORD_H
+#define SATSCM_JSON_RECORD_H
+
+#include <scm.h>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/*!
+ * @return s as JSON string literal
+ */
+std::string json_string(const std::string &s);
+
+/*!
+ * @return constants as JSON array
+ */
+std::string json_array(const std::vector<int> &C);
+
+/*!
+ * append the fields that describe the current solution of solver to a JSON record
+ *   -> "adders", "adder_lower_bound", "full_adders" and "full_adder_lower_bound" (if full adders were counted) and "graph"
+ *   -> "adders_optimal" and "full_adders_optimal" if final is true (they are only meaningful after solver->solve() returned)
+ * each field is preceded by a comma, i.e., the record must already contain at least one field
+ * @param record
+ * @param solver must have a solution
+ * @param final
+ */
+void write_solution_fields(std::ostream &record, scm &solver, bool final);
+
+#endif //SATSCM_JSON_RECORD_H
@@ -0,0 +1,22 @@
+//
+// Created by nfiege on 11/19/22.
+//
+
+#ifndef SATSCM_NULL_BUFFER_H
+#define SATSCM_NULL_BUFFER_H
+
+#include <streambuf>
+
+/*!
+ * stream buffer that drops everything
+ * it has no state, so several threads may write to it at the same time
+ * (used to silence the solver outputs when many problems are solved at once)
+ */
+class null_buffer : public std::streambuf {
+protected:
+	int overflow(int c) override {
+		return traits_type::not_eof(c);
+	}
+};
+
+#endif //SATSCM_NULL_BUFFER_H
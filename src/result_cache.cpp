@@ -0,0 +1,133 @@
+//
+// Created by nfiege on 11/18/22.
+//
+
+#include "result_cache.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+
+bool result_cache::entry::adders_optimal() const {
+	return this->adder_lower_bound >= this->num_adders;
+}
+
+bool result_cache::entry::full_adders_optimal() const {
+	return this->full_adders_known and this->full_adder_lower_bound >= this->full_adders;
+}
+
+result_cache::result_cache(const std::string &directory)
+	: directory(directory) {
+	std::error_code error;
+	std::filesystem::create_directories(directory, error);
+	if (!std::filesystem::is_directory(directory)) throw std::runtime_error("failed to create result cache directory "+directory);
+}
+
+std::string result_cache::get_filename(const std::string &key, const std::string &suffix) const {
+	// 64 bit FNV-1a hash (collisions are detected because the key is stored in the file)
+	uint64_t hash = 14695981039346656037ull;
+	for (auto &c : key) {
+		hash ^= (unsigned char)c;
+		hash *= 1099511628211ull;
+	}
+	std::stringstream s;
+	s << this->directory << "/" << std::hex << std::setw(16) << std::setfill('0') << hash << suffix;
+	return s.str();
+}
+
+bool result_cache::read_file(const std::string &filename, const std::string &key, entry &e) {
+	std::ifstream f(filename);
+	if (!f) return false;
+	entry result;
+	bool key_matches = false;
+	bool has_graph = false;
+	std::string line;
+	try {
+		while (std::getline(f, line)) {
+			auto pos = line.find(' ');
+			if (pos == std::string::npos) continue;
+			auto name = line.substr(0, pos);
+			auto value = line.substr(pos+1);
+			if (name == "key") key_matches = value == key;
+			else if (name == "graph") {
+				result.graph = value;
+				has_graph = true;
+			}
+			else if (name == "adders") result.num_adders = std::stoi(value);
+			else if (name == "adder_lower_bound") result.adder_lower_bound = std::stoi(value);
+			else if (name == "full_adders") {
+				result.full_adders = std::stoll(value);
+				result.full_adders_known = true;
+			}
+			else if (name == "full_adder_lower_bound") result.full_adder_lower_bound = std::stoll(value);
+		}
+	}
+	catch (...) {
+		// corrupt file -> treat it like a cache miss
+		return false;
+	}
+	if (!key_matches or !has_graph) return false;
+	e = result;
+	return true;
+}
+
+bool result_cache::load(const std::string &key, entry &e) const {
+	return read_file(this->get_filename(key, ".txt"), key, e);
+}
+
+void result_cache::store(const std::string &key, const entry &e) const {
+	auto filename = this->get_filename(key, ".txt");
+	auto lock_filename = this->get_filename(key, ".lock");
+	int lock_fd = open(lock_filename.c_str(), O_CREAT | O_RDWR, 0644);
+	if (lock_fd < 0) throw std::runtime_error("failed to open "+lock_filename);
+	flock(lock_fd, LOCK_EX);
+	// merge with the cached result
+	entry merged = e;
+	entry cached;
+	if (read_file(filename, key, cached)) {
+		merged.adder_lower_bound = std::max(cached.adder_lower_bound, e.adder_lower_bound);
+		bool keep_cached_graph = cached.num_adders < e.num_adders;
+		if (cached.num_adders == e.num_adders and cached.full_adders_known) {
+			keep_cached_graph = !e.full_adders_known or cached.full_adders <= e.full_adders;
+			if (e.full_adders_known) merged.full_adder_lower_bound = std::max(cached.full_adder_lower_bound, e.full_adder_lower_bound);
+			else merged.full_adder_lower_bound = cached.full_adder_lower_bound;
+		}
+		if (keep_cached_graph) {
+			merged.graph = cached.graph;
+			merged.num_adders = cached.num_adders;
+			merged.full_adders_known = cached.full_adders_known;
+			merged.full_adders = cached.full_adders;
+			if (cached.num_adders != e.num_adders) merged.full_adder_lower_bound = cached.full_adder_lower_bound;
+		}
+	}
+	std::stringstream tmp_filename;
+	tmp_filename << filename << "." << getpid() << "." << std::hash<std::thread::id>()(std::this_thread::get_id()) << ".tmp";
+	{
+		std::ofstream f(tmp_filename.str(), std::ios::trunc);
+		f << "key " << key << std::endl;
+		f << "graph " << merged.graph << std::endl;
+		f << "adders " << merged.num_adders << std::endl;
+		f << "adder_lower_bound " << merged.adder_lower_bound << std::endl;
+		if (merged.full_adders_known) {
+			f << "full_adders " << merged.full_adders << std::endl;
+			f << "full_adder_lower_bound " << merged.full_adder_lower_bound << std::endl;
+		}
+		if (!f) {
+			flock(lock_fd, LOCK_UN);
+			close(lock_fd);
+			throw std::runtime_error("failed to write "+tmp_filename.str());
+		}
+	}
+	std::error_code error;
+	std::filesystem::rename(tmp_filename.str(), filename, error);
+	flock(lock_fd, LOCK_UN);
+	close(lock_fd);
+	if (error) throw std::runtime_error("failed to replace "+filename+": "+error.message());
+}
@@ -0,0 +1,77 @@
+//
+// Created by nfiege on 11/18/22.
+//
+
+#ifndef SATSCM_RESULT_CACHE_H
+#define SATSCM_RESULT_CACHE_H
+
+#include <cstdint>
+#include <string>
+
+/*!
+ * persistent cache for the results of scm::solve() that can be shared by several processes
+ * each problem is stored in its own file <hash of key>.txt inside the cache directory
+ *   -> files are replaced atomically (write to a temporary file + rename) so readers never need a lock
+ *   -> writers merge their result with the existing one while holding an exclusive lock on <hash of key>.lock
+ */
+class result_cache {
+public:
+	struct entry {
+		/*!
+		 * best adder graph in PAGSuite form (see scm::get_adder_graph_description)
+		 */
+		std::string graph;
+		int num_adders = 0;
+		/*!
+		 * all solutions need at least this many adders
+		 */
+		int adder_lower_bound = 0;
+		/*!
+		 * the full adder count of the graph and a lower bound for the full adder count of all solutions with num_adders adders
+		 * only valid if full_adders_known is set
+		 */
+		bool full_adders_known = false;
+		int64_t full_adders = 0;
+		int64_t full_adder_lower_bound = 0;
+		/*!
+		 * @return whether the adder count is proven optimal
+		 */
+		bool adders_optimal() const;
+		/*!
+		 * @return whether the full adder count is proven optimal
+		 */
+		bool full_adders_optimal() const;
+	};
+	/*!
+	 * constructor
+	 * @param directory cache directory (it is created if it does not exist)
+	 */
+	explicit result_cache(const std::string &directory);
+	/*!
+	 * @param key identifies the problem
+	 * @param e is filled if the problem is in the cache
+	 * @return whether the problem is in the cache
+	 */
+	bool load(const std::string &key, entry &e) const;
+	/*!
+	 * merge a result into the cache
+	 * the best graph and the best bounds of the cached and the new result are kept
+	 * @param key identifies the problem
+	 * @param e the new result
+	 */
+	void store(const std::string &key, const entry &e) const;
+
+private:
+	std::string directory;
+	/*!
+	 * @return the path of the file for key with the given suffix
+	 */
+	std::string get_filename(const std::string &key, const std::string &suffix) const;
+	/*!
+	 * read a cache file
+	 * @return whether the file exists and belongs to key
+	 */
+	static bool read_file(const std::string &filename, const std::string &key, entry &e);
+};
+
+#endif //SATSCM_RESULT_CACHE_H
@@ -9,12 +9,20 @@
 #include <chrono>
 #include <fstream>
 #include <algorithm>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <random>
+#include <cnf_reader.h>
+#include <work_stealing_pool.h>
 
 #define INPUT_SELECT_MUX_OPT 0 // I have NO IDEA WHY but apparently setting this to 0 is faster...
 #define FPGA_ADD 0 // try out full adders as used in FPGAs ... maybe SAT solvers like those better than normal ones?!
 
 scm::scm(const std::vector<int> &C, int timeout, bool quiet, int threads, bool allow_negative_numbers, bool write_cnf)
-	:	C(C), timeout(timeout), quiet(quiet), threads(threads), write_cnf(write_cnf) {
+	:	C(C), timeout(timeout), check_timeout(timeout), quiet(quiet), threads(threads), write_cnf(write_cnf), original_C(C) {
 	// make it even and count shift
 	this->calc_twos_complement = allow_negative_numbers;
 	for (auto &c : this->C) {
@@ -49,6 +57,7 @@ scm::scm(const std::vector<int> &C, int timeout, bool quiet, int threads, bool a
 	}
 	this->shift_word_size = this->ceil_log2(this->max_shift+1);
 	this->num_adders = (int)non_one_unique_constants.size()-1;
+	this->trivial_adder_lower_bound = this->num_adders+1;
 	std::cout << "min num adders = " << this->num_adders+1 << std::endl;
 	// set constants vector
 	this->C.clear();
@@ -59,27 +68,48 @@ scm::scm(const std::vector<int> &C, int timeout, bool quiet, int threads, bool a
 
 void scm::optimization_loop(formulation_mode mode) {
 	if (!this->quiet) std::cout << "  starting optimization loop (mode = " << mode << ")" << std::endl;
+	if (this->budget.expired()) {
+		// don't even construct the problem
+		std::cout << "  no time left for #adders = " << this->num_adders << (this->max_full_adders!=FULL_ADDERS_UNLIMITED?" and max. "+std::to_string(this->max_full_adders)+" full adders":"") << std::endl;
+		this->found_solution = false;
+		this->ran_into_timeout = true;
+		return;
+	}
 	auto start_time = std::chrono::steady_clock::now();
-	if (!this->quiet) std::cout << "  resetting backend now" << std::endl;
-	this->reset_backend(mode);
-	if (!this->quiet) std::cout << "  constructing problem for " << this->num_adders << " adders" << (this->max_full_adders!=FULL_ADDERS_UNLIMITED?" and "+std::to_string(this->max_full_adders)+" full adders":"") << std::endl;
-	this->construct_problem(mode);
-	if (!this->quiet) std::cout << "  start solving with " << this->variable_counter << " variables and " << this->constraint_counter << " constraints" << std::endl;
-	auto [a, b] = this->check();
+	std::pair<bool, bool> result;
+	if (this->cube_workers > 1) {
+		// the workers build their own problems
+		result = this->cube_and_conquer();
+	}
+	else {
+		if (!this->quiet) std::cout << "  resetting backend now" << std::endl;
+		this->reset_backend(mode);
+		if (!this->quiet) std::cout << "  constructing problem for " << this->num_adders << " adders" << (this->max_full_adders!=FULL_ADDERS_UNLIMITED?" and "+std::to_string(this->max_full_adders)+" full adders":"") << std::endl;
+		this->construct_problem(mode);
+		this->seed_phases(mode);
+		if (!this->quiet) std::cout << "  start solving with " << this->variable_counter << " variables and " << this->constraint_counter << " constraints" << std::endl;
+		// the time for constructing the problem counts as well
+		this->check_timeout = this->budget.get_slice(this->timeout);
+		result = this->check_timeout > 0.0 ? this->check() : std::make_pair(false, true);
+	}
+	auto [a, b] = result;
 	auto elapsed_time = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_time).count() / 1000.0;
-	this->fa_minimization_timeout -= elapsed_time;
 	this->found_solution = a;
 	this->ran_into_timeout = b;
 	if (this->found_solution) {
 		std::cout << "  found solution for #adders = " << this->num_adders << (this->max_full_adders!=FULL_ADDERS_UNLIMITED?" and max. "+std::to_string(this->max_full_adders)+" full adders":"") << " after " << elapsed_time << " seconds 8-)" << std::endl;
-		this->get_solution_from_backend();
-		if (this->solution_is_valid()) {
+		// the worker that solved the cube already verified the solution in its backend
+		if (this->cube_workers <= 1) this->get_solution_from_backend();
+		if (this->cube_workers > 1 or this->solution_is_valid()) {
 			std::cout << "Solution is verified :-)" << std::endl;
 		}
 		else {
 			throw std::runtime_error("Solution is invalid (found bug) :-(");
 		}
 	}
+	else if (this->ran_into_timeout and this->interrupt_requested) {
+		std::cout << "  attempt for #adders = " << this->num_adders << " was canceled after " << elapsed_time << " seconds" << std::endl;
+	}
 	else if (this->ran_into_timeout) {
 		std::cout << "  ran into timeout for #adders = " << this->num_adders << (this->max_full_adders!=FULL_ADDERS_UNLIMITED?" and max. "+std::to_string(this->max_full_adders)+" full adders":"") << " after " << elapsed_time << " seconds :-(" << std::endl;
 	}
@@ -89,6 +119,7 @@ void scm::optimization_loop(formulation_mode mode) {
 }
 
 void scm::solve() {
+	this->budget.start();
 	this->num_FA_opt = true;
 	this->num_add_opt = true;
 	if (!this->quiet) {
@@ -111,117 +142,1232 @@ void scm::solve() {
 		this->output_values[0] = 1;
 		return;
 	}
+	if (this->graph_table != nullptr and this->solve_from_table()) {
+		this->report_solution();
+		return;
+	}
+	if (this->cache != nullptr and this->solve_from_cache()) {
+		this->report_solution();
+		return;
+	}
+	if (this->incremental_solving and !this->supports_assumptions()) {
+		std::cout << "Backend does not support assumptions -> rebuild the problem for each number of adders" << std::endl;
+		this->incremental_solving = false;
+	}
+	if (this->cube_workers > 1 and !this->supports_assumptions()) {
+		std::cout << "Backend does not support assumptions -> solve without cube-and-conquer" << std::endl;
+		this->cube_workers = 1;
+	}
+	if (this->cube_workers > 1 and this->incremental_solving) {
+		std::cout << "Cube-and-conquer always rebuilds the problem -> ignore incremental solving" << std::endl;
+		this->incremental_solving = false;
+	}
+	if (this->lns_workers > 0 and !this->supports_assumptions()) {
+		std::cout << "Backend does not support assumptions -> use the exact search instead of the large neighbourhood search" << std::endl;
+		this->lns_workers = 0;
+	}
+	if (this->lns_workers > 0 or this->max_cluster_size > 0) {
+		// the large neighbourhood search needs a start solution
+		this->use_heuristic = true;
+	}
+	if (this->use_heuristic) {
+		auto start_time = std::chrono::steady_clock::now();
+		auto graph = create_heuristic_adder_graph(this->C, this->word_size - (this->calc_twos_complement?1:0), this->max_shift);
+		auto elapsed_time = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_time).count() / 1000.0;
+		std::cout << "  heuristic found solution for #adders = " << graph.size() << " after " << elapsed_time << " seconds" << std::endl;
+		// the cache might already know a better one
+		if (this->heuristic_graph.empty() or graph.size() < this->heuristic_graph.size()) this->heuristic_graph = graph;
+	}
+	// the heuristic or cached solution is the first one the listener gets (the search might take a while)
+	this->adder_lower_bound = this->num_adders+1;
+	this->report_graph(this->heuristic_graph);
+	if (this->max_cluster_size > 0 and (int)this->C.size() > this->max_cluster_size) {
+		this->partition_and_merge();
+		this->store_in_cache();
+		return;
+	}
+	if (this->lns_workers > 0) {
+		this->large_neighbourhood_search();
+		this->store_in_cache();
+		return;
+	}
+	if (this->minimize_full_adders and !this->heuristic_graph.empty()) {
+		// there is a solution to minimize -> leave time for the full adder phase
+		this->budget.reserve_full_adder_phase();
+	}
+	this->adder_lower_bound = this->num_adders+1;
+	bool bounded_search = this->adder_search_strategy != adder_search::bottom_up_adder_search;
+	if (bounded_search and this->heuristic_graph.empty()) {
+		std::cout << "No upper bound for the adder count -> search bottom-up" << std::endl;
+		bounded_search = false;
+	}
+	if (bounded_search and this->incremental_solving) {
+		std::cout << "Top-down and binary search rebuild the problem for each number of adders -> ignore incremental solving" << std::endl;
+		this->incremental_solving = false;
+	}
+	if (this->restricted_max_shift > 0) {
+		auto instance = this->create_instance(this->original_C);
+		this->copy_settings_to(*instance);
+		instance->incremental_solving = this->incremental_solving;
+		instance->restrict_domain(this->restricted_max_shift);
+		// the smaller problem must not overwrite the CNF files of the full problem
+		instance->write_cnf = false;
+		instance->timeout = std::max(1, this->timeout / 4);
+		std::cout << "  restricted domain pass with word size " << instance->word_size << " and max shift " << instance->max_shift << std::endl;
+		std::lock_guard<std::mutex> lock(this->restricted_instance_mutex);
+		this->restricted_instance = std::move(instance);
+		this->restricted_mode = formulation_mode::reset_all;
+		if (this->interrupt_requested) this->restricted_instance->interrupt();
+	}
 	formulation_mode mode = formulation_mode::reset_all;
+	// whether the backend contains the problem for the solution
+	bool solution_in_backend = false;
+	if (this->parallel_adder_counts > 1) {
+		this->parallel_adder_count_search();
+	}
+	if (bounded_search and !this->found_solution) {
+		solution_in_backend = this->bounded_adder_search();
+	}
 	while (!this->found_solution) {
-		this->fa_minimization_timeout = this->timeout;
 		++this->num_adders;
+		if (!this->heuristic_graph.empty() and this->num_adders >= (int)this->heuristic_graph.size()) {
+			// the SAT search can't improve on the heuristic anymore
+			std::cout << "  using heuristic solution for #adders = " << this->heuristic_graph.size() << std::endl;
+			this->set_adder_graph(this->heuristic_graph);
+			break;
+		}
+		if (this->restricted_instance != nullptr and this->solve_in_restricted_domain()) {
+			break;
+		}
 		this->optimization_loop(mode);
+		solution_in_backend = this->found_solution;
 		if (this->ran_into_timeout) {
 			// timeout => can't say anything about optimality
 			this->num_add_opt = false;
 		}
+		else if (!this->found_solution and this->num_add_opt) {
+			// all adder counts up to this one are infeasible
+			this->adder_lower_bound = this->num_adders+1;
+		}
+		if (!this->found_solution and (this->interrupt_requested or this->budget.expired())) {
+			// stop here and fall back to the start solution (if there is one)
+			std::string reason = this->interrupt_requested ? "interrupted" : "out of time";
+			if (!this->heuristic_graph.empty()) {
+				std::cout << "  " << reason << " -> using heuristic solution for #adders = " << this->heuristic_graph.size() << std::endl;
+				this->set_adder_graph(this->heuristic_graph);
+				break;
+			}
+			std::cout << "  " << reason << " before finding a solution" << std::endl;
+			this->num_FA_opt = false;
+			return;
+		}
+		if (this->incremental_solving) {
+			// keep everything and only add the next node
+			mode = formulation_mode::add_node;
+		}
+	}
+	{
+		std::lock_guard<std::mutex> lock(this->restricted_instance_mutex);
+		this->restricted_instance.reset();
 	}
 	// check if we should even optimize the number of full adders and return if not
 	if (!this->minimize_full_adders) {
+		this->report_solution();
 		this->num_FA_opt = false; // don't know if solution is optimal w.r.t. full adders
+		this->store_in_cache();
 		return;
 	}
-	mode = formulation_mode::all_FA_clauses;
-	while (this->found_solution) {
-		this->timeout = this->fa_minimization_timeout;
-		// count current # of full adders
-		// except for the last node because its output always has a constant number of full adders
-		int current_full_adders = 0;
-		int MSBs_cut = 0;
-		int MSBs_not_cut = 0;
-		for (int idx = 1; idx <= this->num_adders; idx++) {
-			if (this->output_values.at(idx) == 0) {
-				// more adders allocated than necessary
-				continue;
+	// add the FA constraints to the problem in the backend
+	// or start from scratch if the solution was found elsewhere
+	mode = solution_in_backend ? formulation_mode::all_FA_clauses : formulation_mode::reset_all;
+	// the whole full adder phase gets the timeout of a single call (and the rest of the budget)
+	this->budget.start_full_adder_phase(this->timeout);
+	// the limit can only be relaxed again if it is passed via assumptions
+	// otherwise, the problem must be rebuilt for each new limit
+	bool monotone_limit = this->full_adder_search_strategy == full_adder_search::linear_FA_search;
+	auto next_mode = (monotone_limit or this->supports_assumptions()) ? formulation_mode::only_FA_limit : formulation_mode::reset_all;
+	auto current_full_adders = this->count_full_adders();
+	std::cout << "Initial solution needs " << current_full_adders << " full adders" << std::endl;
+	this->print_solution();
+	this->full_adder_upper_bound = current_full_adders;
+	// trivial minimum value or the one from the cache
+	this->full_adder_lower_bound = -(this->num_adders * (this->max_shift+1));
+	if (this->num_adders == this->cached_num_adders) this->full_adder_lower_bound = std::max(this->full_adder_lower_bound, this->cached_full_adder_lower_bound);
+	this->report_solution();
+	while (this->full_adder_lower_bound < this->full_adder_upper_bound) {
+		switch (this->full_adder_search_strategy) {
+			case full_adder_search::linear_FA_search: {
+				this->max_full_adders = this->full_adder_upper_bound - 1;
+				break;
 			}
-			int FAs_for_this_node = (int)std::ceil(std::log2(std::abs(this->add_result_values.at(idx))));
-			int shifter_input_non_zero_LSBs = 0;
-			int shifter_input = 1;
-			if (idx > 1) {
-				shifter_input = this->input_select_mux_output.at({idx, scm::left});
+			case full_adder_search::binary_FA_search:
+			case full_adder_search::core_guided_FA_search: {
+				this->max_full_adders = this->full_adder_lower_bound + (this->full_adder_upper_bound - 1 - this->full_adder_lower_bound) / 2;
+				break;
 			}
-			while ((shifter_input & 1) == 0) {
-				shifter_input = shifter_input >> 1;
-				shifter_input_non_zero_LSBs++;
+		}
+		this->optimization_loop(mode);
+		mode = next_mode;
+		if (this->found_solution) {
+			current_full_adders = this->count_full_adders();
+			if (current_full_adders > this->max_full_adders) {
+				this->print_solution();
+				throw std::runtime_error("SAT solver exceeded full adder limit! Limit was "+std::to_string(this->max_full_adders)+" but solver returned solution with "+std::to_string(current_full_adders)+" FAs!");
 			}
-			if (this->subtract.at(idx) == 0 or this->negate_select.at(idx) == 0) {
-				// we do not need to use a full adder for the shifted LSBs
-				//   for a + b
-				//   and a - (b << s)
-				FAs_for_this_node -= (this->shift_value.at(idx) + shifter_input_non_zero_LSBs);
+			std::cout << "Current solution needs " << current_full_adders << " full adders" << std::endl;
+			this->print_solution();
+			this->full_adder_upper_bound = current_full_adders;
+			this->report_solution();
+		}
+		else if (this->ran_into_timeout) {
+			// timeout => can't say anything about optimality
+			// and there is no time left because each call gets the remaining time of the phase
+			this->num_FA_opt = false;
+			break;
+		}
+		else {
+			// all limits <= max_full_adders are infeasible
+			// the UNSAT core might even prove that for larger limits
+			this->full_adder_lower_bound = std::max(this->full_adder_lower_bound, this->max_full_adders + 1);
+			if (this->full_adder_search_strategy == full_adder_search::core_guided_FA_search) {
+				this->full_adder_lower_bound = std::max(this->full_adder_lower_bound, this->get_infeasible_full_adder_limit() + 1);
 			}
+		}
+	}
+	std::cout << "Proven full adder bounds: [" << this->full_adder_lower_bound << ", " << this->full_adder_upper_bound << "]" << std::endl;
+	this->found_solution = true;
+	this->store_in_cache();
+}
 
-			auto can_cut_MSB = (this->output_values.at(idx) >= 0 and this->input_select_mux_output[{idx, scm::left}]  >= 0) or
-												 (this->output_values.at(idx) >= 0 and this->input_select_mux_output[{idx, scm::right}] >= 0) or
-												 (this->output_values.at(idx)  < 0 and this->input_select_mux_output[{idx, scm::left}]   < 0) or
-												 (this->output_values.at(idx)  < 0 and this->input_select_mux_output[{idx, scm::right}]  < 0);
-			if (can_cut_MSB) {
-				MSBs_cut++;
+long int scm::get_infeasible_full_adder_limit() {
+	if (this->full_adder_limit_variables.empty()) return this->max_full_adders;
+	// the UNSAT proof only depends on the limit bits in the core
+	// -> set all other bits such that the limit becomes as large as possible
+	int msb = (int)this->full_adder_limit_variables.size()-1;
+	long int limit = 0;
+	for (auto &it : this->full_adder_limit_variables) {
+		auto w = it.first;
+		long int bit = (this->max_full_adders >> w) & 1;
+		if (!this->assumption_failed({it.second, bit == 0})) {
+			bit = w == msb ? 0 : 1;
+		}
+		if (w == msb) limit -= (bit << w);
+		else limit += (bit << w);
+	}
+	return limit;
+}
+
+int scm::count_full_adders() {
+	// count current # of full adders
+	// except for the last node because its output always has a constant number of full adders
+	int current_full_adders = 0;
+	int MSBs_cut = 0;
+	int MSBs_not_cut = 0;
+	for (int idx = 1; idx <= this->num_adders; idx++) {
+		if (this->output_values.at(idx) == 0) {
+			// more adders allocated than necessary
+			continue;
+		}
+		int FAs_for_this_node = (int)std::ceil(std::log2(std::abs(this->add_result_values.at(idx))));
+		int shifter_input_non_zero_LSBs = 0;
+		int shifter_input = 1;
+		if (idx > 1) {
+			shifter_input = this->input_select_mux_output.at({idx, scm::left});
+		}
+		while ((shifter_input & 1) == 0) {
+			shifter_input = shifter_input >> 1;
+			shifter_input_non_zero_LSBs++;
+		}
+		if (this->subtract.at(idx) == 0 or this->negate_select.at(idx) == 0) {
+			// we do not need to use a full adder for the shifted LSBs
+			//   for a + b
+			//   and a - (b << s)
+			FAs_for_this_node -= (this->shift_value.at(idx) + shifter_input_non_zero_LSBs);
+		}
+
+		auto can_cut_MSB = (this->output_values.at(idx) >= 0 and this->input_select_mux_output[{idx, scm::left}]  >= 0) or
+											 (this->output_values.at(idx) >= 0 and this->input_select_mux_output[{idx, scm::right}] >= 0) or
+											 (this->output_values.at(idx)  < 0 and this->input_select_mux_output[{idx, scm::left}]   < 0) or
+											 (this->output_values.at(idx)  < 0 and this->input_select_mux_output[{idx, scm::right}]  < 0);
+		if (can_cut_MSB) {
+			MSBs_cut++;
+		}
+		else {
+			MSBs_not_cut++;
+		}
+		if (!this->quiet) std::cout << "FAs for node " << idx << " = " << (can_cut_MSB?FAs_for_this_node-1:FAs_for_this_node) << std::endl;
+		current_full_adders += (FAs_for_this_node - ((int)can_cut_MSB));
+	}
+	return current_full_adders;
+}
+
+void scm::parallel_adder_count_search() {
+	if (this->incremental_solving) {
+		std::cout << "Parallel attempts always rebuild the problem -> ignore incremental solving for the adder count" << std::endl;
+	}
+	std::mutex result_mutex;
+	std::condition_variable result_cv;
+	std::map<int, std::unique_ptr<scm>> instances;
+	std::map<int, std::thread> attempts;
+	std::set<int> finished;
+	std::set<int> handled;
+	std::exception_ptr error = nullptr;
+	int best_num_adders = std::numeric_limits<int>::max();
+	int next_num_adders = this->num_adders+1;
+	// never try adder counts that are not better than the heuristic solution
+	int max_num_adders = this->heuristic_graph.empty() ? std::numeric_limits<int>::max() : (int)this->heuristic_graph.size()-1;
+	auto start_attempt = [&]() {
+		if (next_num_adders > max_num_adders or this->budget.expired()) return;
+		int k = next_num_adders++;
+		if (!this->quiet) std::cout << "  starting attempt for #adders = " << k << std::endl;
+		auto instance = this->create_instance(this->original_C);
+		this->copy_settings_to(*instance);
+		instance->num_adders = k;
+		auto instance_ptr = instance.get();
+		instances[k] = std::move(instance);
+		attempts[k] = std::thread([&, instance_ptr, k]() {
+			try {
+				instance_ptr->optimization_loop(formulation_mode::reset_all);
 			}
-			else {
-				MSBs_not_cut++;
+			catch (...) {
+				std::lock_guard<std::mutex> lock(result_mutex);
+				if (error == nullptr) error = std::current_exception();
+			}
+			{
+				std::lock_guard<std::mutex> lock(result_mutex);
+				finished.insert(k);
+			}
+			result_cv.notify_all();
+		});
+	};
+	std::unique_lock<std::mutex> lock(result_mutex);
+	for (int i=0; i<this->parallel_adder_counts; i++) {
+		start_attempt();
+	}
+	while (handled.size() < attempts.size()) {
+		result_cv.wait_for(lock, std::chrono::milliseconds(10));
+		for (auto &k : finished) {
+			if (handled.find(k) != handled.end()) continue;
+			handled.insert(k);
+			if (instances.at(k)->found_solution) {
+				if (k < best_num_adders) this->report_graph(instances.at(k)->get_adder_graph());
+				best_num_adders = std::min(best_num_adders, k);
+			}
+			else if (error == nullptr and !this->interrupt_requested and next_num_adders < best_num_adders) {
+				// keep the number of running attempts constant
+				start_attempt();
 			}
-			std::cout << "FAs for node " << idx << " = " << (can_cut_MSB?FAs_for_this_node-1:FAs_for_this_node) << std::endl;
-			current_full_adders += (FAs_for_this_node - ((int)can_cut_MSB));
 		}
-		if (this->max_full_adders == FULL_ADDERS_UNLIMITED) {
-			std::cout << "Initial solution needs " << current_full_adders << " full adders" << std::endl;
-			this->print_solution();
+		for (auto &it : attempts) {
+			// a solution exists -> nobody needs the results above it
+			// repeat this until they are done because an attempt might not have started solving yet
+			if (finished.find(it.first) != finished.end()) continue;
+			if (error != nullptr or this->interrupt_requested or it.first > best_num_adders) {
+				instances.at(it.first)->interrupt();
+			}
 		}
-		else if (current_full_adders > this->max_full_adders) {
-			this->print_solution();
-			throw std::runtime_error("SAT solver exceeded full adder limit! Limit was "+std::to_string(this->max_full_adders)+" but solver returned solution with "+std::to_string(current_full_adders)+" FAs!");
+	}
+	lock.unlock();
+	for (auto &it : attempts) {
+		it.second.join();
+	}
+	if (error != nullptr) std::rethrow_exception(error);
+	// all adder counts up to this one are proven to be infeasible
+	// (attempts that ran into a timeout or were never started because we ran out of time leave a gap)
+	int proven_infeasible = this->num_adders;
+	while (instances.find(proven_infeasible+1) != instances.end()) {
+		auto &instance = instances.at(proven_infeasible+1);
+		if (instance->found_solution or instance->ran_into_timeout) break;
+		proven_infeasible++;
+	}
+	this->adder_lower_bound = std::max(this->adder_lower_bound, proven_infeasible+1);
+	if (best_num_adders == std::numeric_limits<int>::max()) {
+		if (this->heuristic_graph.empty()) {
+			// continue after the counts that are known to be infeasible
+			this->num_adders = proven_infeasible;
+			return;
+		}
+		std::cout << "  using heuristic solution for #adders = " << this->heuristic_graph.size() << std::endl;
+		this->set_adder_graph(this->heuristic_graph);
+		// can't say anything about the counts in the gap
+		if (proven_infeasible+1 < (int)this->heuristic_graph.size()) this->num_add_opt = false;
+		return;
+	}
+	std::cout << "  parallel attempts found the best solution for #adders = " << best_num_adders << std::endl;
+	if (proven_infeasible+1 < best_num_adders) this->num_add_opt = false;
+	this->num_adders = best_num_adders;
+	this->copy_solution_from(*instances.at(best_num_adders));
+	this->found_solution = true;
+	this->ran_into_timeout = false;
+}
+
+std::vector<int> scm::get_cube_variables() {
+	// the first nodes decide the structure of the whole graph -> their inputs split the problem into balanced parts
+	// the MSBs come first because they halve the range of the select and shift values
+	std::vector<int> variables;
+	for (int idx = 1; idx <= this->num_adders; idx++) {
+		if (idx > 1) {
+			for (auto &dir : this->input_directions) {
+				for (int w = this->ceil_log2(idx)-1; w >= 0; w--) {
+					auto it = this->input_select_selection_variables.find({idx, dir, w});
+					if (it != this->input_select_selection_variables.end()) variables.emplace_back(it->second);
+				}
+			}
+		}
+		for (int w = this->shift_word_size-1; w >= 0; w--) {
+			auto it = this->input_shift_value_variables.find({idx, w});
+			if (it != this->input_shift_value_variables.end()) variables.emplace_back(it->second);
+		}
+		auto it = this->input_negate_value_variables.find(idx);
+		if (it != this->input_negate_value_variables.end()) variables.emplace_back(it->second);
+	}
+	return variables;
+}
+
+std::pair<bool, bool> scm::cube_and_conquer() {
+	// the time for constructing the problems counts as well
+	auto deadline = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(this->budget.get_slice(this->timeout)));
+	auto seconds_left = [&]() {
+		return std::chrono::duration<double>(deadline - std::chrono::steady_clock::now()).count();
+	};
+	struct cube {
+		// < variable idx, negate > for the first literals.size() cube variables
+		std::vector<std::pair<int, bool>> literals;
+		double time_slice;
+	};
+	std::mutex state_mutex;
+	std::condition_variable state_cv;
+	std::vector<std::unique_ptr<scm>> instances;
+	// instances that currently don't solve a cube (there is always one for each running task)
+	std::vector<scm*> idle_instances;
+	std::exception_ptr error = nullptr;
+	scm *winner = nullptr;
+	// whether a cube could not be decided (timeout or interrupt)
+	bool incomplete = false;
+	int open_cubes = 0;
+	int solved_cubes = 0;
+	int split_cubes = 0;
+	auto exchange = std::make_shared<clause_exchange>();
+	auto create_worker_instance = [&](bool write_cnf) {
+		auto instance = this->create_instance(this->original_C);
+		this->copy_settings_to(*instance);
+		instance->num_adders = this->num_adders;
+		instance->max_full_adders = this->max_full_adders;
+		// the workers solve the same problem -> only one of them writes its CNF file
+		// and they can share what they learn about it
+		instance->write_cnf = write_cnf;
+		instance->share_learned_clauses(exchange);
+		// start at the best solution (if there is one)
+		instance->copy_solution_from(*this);
+		instance->reset_backend(formulation_mode::reset_all);
+		instance->construct_problem(formulation_mode::reset_all);
+		instance->seed_phases(formulation_mode::reset_all);
+		return instance;
+	};
+	if (!this->quiet) std::cout << "  constructing problem for " << this->num_adders << " adders" << (this->max_full_adders!=FULL_ADDERS_UNLIMITED?" and "+std::to_string(this->max_full_adders)+" full adders":"") << std::endl;
+	instances.emplace_back(create_worker_instance(this->write_cnf));
+	idle_instances.emplace_back(instances.back().get());
+	// all instances use the same variable indices
+	auto cube_variables = instances.back()->get_cube_variables();
+	if (!this->quiet) std::cout << "  start solving with " << instances.back()->variable_counter << " variables and " << instances.back()->constraint_counter << " constraints" << std::endl;
+	// a few cubes per worker so that the workers stay busy if some cubes are easy
+	int depth = 0;
+	while ((1 << depth) < 4*this->cube_workers and depth < (int)cube_variables.size()) depth++;
+	{
+		work_stealing_pool pool(this->cube_workers);
+		std::function<void(cube)> submit_cube;
+		auto solve_cube = [&](const cube &c) {
+			scm *instance = nullptr;
+			// the other workers change the shared state -> only decide under the lock whether to solve this cube
+			bool skip = false;
+			{
+				std::lock_guard<std::mutex> lock(state_mutex);
+				if (winner != nullptr or error != nullptr or this->interrupt_requested) {
+					incomplete = true;
+					skip = true;
+				}
+				else if (!idle_instances.empty()) {
+					instance = idle_instances.back();
+					idle_instances.pop_back();
+				}
+			}
+			try {
+				if (instance == nullptr and !skip) {
+					auto new_instance = create_worker_instance(false);
+					instance = new_instance.get();
+					std::lock_guard<std::mutex> lock(state_mutex);
+					instances.emplace_back(std::move(new_instance));
+				}
+				if (instance != nullptr) {
+					instance->collect_assumptions();
+					instance->assumptions.insert(instance->assumptions.end(), c.literals.begin(), c.literals.end());
+					bool can_split = c.literals.size() < cube_variables.size();
+					instance->check_timeout = can_split ? std::min(c.time_slice, seconds_left()) : seconds_left();
+					auto [sat, to] = instance->check_timeout > 0.0 ? instance->check() : std::make_pair(false, true);
+					if (sat) {
+						instance->get_solution_from_backend();
+						if (!instance->solution_is_valid()) throw std::runtime_error("Solution is invalid (found bug) :-(");
+					}
+					std::lock_guard<std::mutex> lock(state_mutex);
+					if (sat) {
+						if (winner == nullptr) winner = instance;
+					}
+					else if (!to) {
+						solved_cubes++;
+					}
+					else if (winner == nullptr and can_split and seconds_left() > 0.0 and !this->interrupt_requested) {
+						// the cube is too hard -> split it on the next variable
+						split_cubes++;
+						for (auto negate : {true, false}) {
+							auto sub_cube = c;
+							sub_cube.literals.emplace_back(cube_variables[c.literals.size()], negate);
+							sub_cube.time_slice *= 2;
+							submit_cube(std::move(sub_cube));
+						}
+					}
+					else {
+						incomplete = true;
+					}
+					if (instance != winner) idle_instances.emplace_back(instance);
+				}
+			}
+			catch (...) {
+				std::lock_guard<std::mutex> lock(state_mutex);
+				if (error == nullptr) error = std::current_exception();
+			}
+			{
+				std::lock_guard<std::mutex> lock(state_mutex);
+				open_cubes--;
+			}
+			state_cv.notify_all();
+		};
+		// must be called while holding state_mutex
+		submit_cube = [&](cube c) {
+			open_cubes++;
+			pool.submit([&, c = std::move(c)]() { solve_cube(c); });
+		};
+		std::unique_lock<std::mutex> lock(state_mutex);
+		for (int i = 0; i < (1 << depth); i++) {
+			cube c;
+			c.time_slice = this->cube_split_after;
+			for (int v = 0; v < depth; v++) {
+				c.literals.emplace_back(cube_variables[v], ((i >> (depth-1-v)) & 1) == 0);
+			}
+			submit_cube(std::move(c));
+		}
+		if (!this->quiet) std::cout << "  split problem into " << (1 << depth) << " cubes for " << this->cube_workers << " workers" << std::endl;
+		while (open_cubes > 0) {
+			state_cv.wait_for(lock, std::chrono::milliseconds(10));
+			if (winner != nullptr or error != nullptr or this->interrupt_requested or seconds_left() <= 0.0) {
+				// nobody needs the other cubes anymore
+				// repeat this until they are done because a worker might not have started solving yet
+				for (auto &it : instances) {
+					if (it.get() != winner) it->interrupt();
+				}
+			}
+		}
+	}
+	if (error != nullptr) std::rethrow_exception(error);
+	if (!this->quiet) std::cout << "  workers proved " << solved_cubes << " cubes infeasible and split " << split_cubes << " cubes" << std::endl;
+	if (winner != nullptr) {
+		this->copy_solution_from(*winner);
+		return {true, false};
+	}
+	return {false, incomplete};
+}
+
+std::vector<std::pair<int, bool>> scm::get_node_assumptions(int idx, const adder_graph_node &node, bool fix_left_input, bool fix_right_input) {
+	std::vector<std::pair<int, bool>> literals;
+	auto fix_number = [&](auto &variables, auto key_of_bit, int64_t value, int num_bits) {
+		for (int w = 0; w < num_bits; w++) {
+			auto it = variables.find(key_of_bit(w));
+			if (it == variables.end()) continue;
+			literals.emplace_back(it->second, ((value >> w) & 1) == 0);
+		}
+	};
+	if (fix_left_input) fix_number(this->input_select_selection_variables, [&](int w) { return std::make_tuple(idx, scm::left, w); }, node.left_input, this->word_size);
+	if (fix_right_input) fix_number(this->input_select_selection_variables, [&](int w) { return std::make_tuple(idx, scm::right, w); }, node.right_input, this->word_size);
+	fix_number(this->input_shift_value_variables, [&](int w) { return std::make_pair(idx, w); }, node.shift, this->shift_word_size);
+	fix_number(this->input_negate_select_variables, [&](int) { return idx; }, node.negate_select, 1);
+	fix_number(this->input_negate_value_variables, [&](int) { return idx; }, node.subtract, 1);
+	if (this->enable_node_output_shift) {
+		fix_number(this->input_post_adder_shift_value_variables, [&](int w) { return std::make_pair(idx, w); }, node.post_adder_shift, this->shift_word_size);
+	}
+	return literals;
+}
+
+void scm::large_neighbourhood_search() {
+	this->adder_lower_bound = this->num_adders+1;
+	this->set_adder_graph(this->heuristic_graph);
+	// there are no proofs except for the trivial lower bounds
+	this->num_add_opt = this->num_adders <= this->adder_lower_bound;
+	this->num_FA_opt = false;
+	long int best_full_adders = FULL_ADDERS_UNLIMITED;
+	if (this->minimize_full_adders) {
+		best_full_adders = this->count_full_adders();
+		this->full_adder_upper_bound = best_full_adders;
+		this->full_adder_lower_bound = -(this->num_adders * (this->max_shift+1));
+	}
+	std::cout << "  starting large neighbourhood search at #adders = " << this->num_adders << (this->minimize_full_adders?" and "+std::to_string(best_full_adders)+" full adders":"") << std::endl;
+	this->report_solution();
+	// nothing is proven anyway -> use the whole budget (or the timeout if there is no budget)
+	double total_seconds = this->budget.is_limited() ? this->budget.get_slice(std::numeric_limits<double>::infinity()) : (double)this->timeout;
+	auto deadline = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(total_seconds));
+	auto seconds_left = [&]() {
+		return std::chrono::duration<double>(deadline - std::chrono::steady_clock::now()).count();
+	};
+	std::mutex state_mutex;
+	std::condition_variable state_cv;
+	auto best_graph = this->heuristic_graph;
+	// incremented for each accepted improvement
+	int best_version = 0;
+	int reported_version = 0;
+	int num_windows = 0;
+	int num_finished = 0;
+	bool stop = false;
+	std::exception_ptr error = nullptr;
+	// the instance that each worker is solving with right now (nullptr if none)
+	std::vector<scm*> active_instances(this->lns_workers, nullptr);
+	auto create_worker_instance = [&](int num_adders, bool limit_full_adders, const std::vector<adder_graph_node> &graph) {
+		auto instance = this->create_instance(this->original_C);
+		this->copy_settings_to(*instance);
+		// the fixed nodes might violate the symmetry breaking rules (e.g., those of the heuristic solution)
+		instance->symmetry_breaking = false;
+		instance->write_cnf = false;
+		// the workers run in parallel -> only this instance prints anything
+		instance->quiet = true;
+		// start at the solution that we want to improve
+		instance->set_adder_graph(graph);
+		instance->num_adders = num_adders;
+		// the full adder constraints are only needed for the limit (which is passed via assumptions)
+		instance->max_full_adders = limit_full_adders ? 0 : FULL_ADDERS_UNLIMITED;
+		instance->reset_backend(formulation_mode::reset_all);
+		instance->construct_problem(formulation_mode::reset_all);
+		instance->seed_phases(formulation_mode::reset_all);
+		return instance;
+	};
+	auto run_worker = [&](int worker_idx) {
+		std::mt19937 rng(this->random_seed + worker_idx + 1);
+		// < #adders, with full adder limit > -> instance (the problems only change when the adder count decreases)
+		std::map<std::pair<int, bool>, std::unique_ptr<scm>> instances;
+		while (true) {
+			std::vector<adder_graph_node> graph;
+			long int full_adders;
+			{
+				std::lock_guard<std::mutex> lock(state_mutex);
+				if (stop) break;
+				graph = best_graph;
+				full_adders = best_full_adders;
+			}
+			int k = (int)graph.size();
+			bool can_remove_node = k-1 >= this->adder_lower_bound;
+			// without full adder minimization, there is nothing else to improve
+			if (!can_remove_node and !this->minimize_full_adders) break;
+			bool remove_node = can_remove_node and (!this->minimize_full_adders or rng() % 2 == 0);
+			for (auto it = instances.begin(); it != instances.end();) {
+				// the problems for larger adder counts are useless after an improvement
+				if (it->first.first > k or it->first == std::make_pair(k, false)) it = instances.erase(it);
+				else ++it;
+			}
+			auto &instance = instances[{remove_node ? k-1 : k, !remove_node}];
+			if (instance == nullptr) instance = create_worker_instance(remove_node ? k-1 : k, !remove_node, graph);
+			// fix all nodes outside of the window
+			int window_size = std::min(this->lns_window_size, k);
+			int first = 1 + (int)(rng() % (k - window_size + 1));
+			int last = first + window_size - 1;
+			instance->max_full_adders = remove_node ? FULL_ADDERS_UNLIMITED : full_adders - 1;
+			instance->collect_assumptions();
+			// nodes behind the window move one position down if the window loses a node
+			auto new_index = [&](int idx) { return (remove_node and idx > last) ? idx-1 : idx; };
+			for (int idx = 1; idx <= k; idx++) {
+				if (idx >= first and idx <= last) continue;
+				auto node = graph[idx-1];
+				// inputs from the window are free because the window nodes may be rearranged
+				bool fix_left_input = node.left_input < first or node.left_input > last;
+				bool fix_right_input = node.right_input < first or node.right_input > last;
+				node.left_input = new_index(node.left_input);
+				node.right_input = new_index(node.right_input);
+				auto literals = instance->get_node_assumptions(new_index(idx), node, fix_left_input, fix_right_input);
+				instance->assumptions.insert(instance->assumptions.end(), literals.begin(), literals.end());
+			}
+			{
+				std::lock_guard<std::mutex> lock(state_mutex);
+				if (stop) break;
+				active_instances[worker_idx] = instance.get();
+			}
+			instance->check_timeout = std::min({this->lns_window_timeout, (double)this->timeout, seconds_left()});
+			auto [sat, to] = instance->check_timeout > 0.0 ? instance->check() : std::make_pair(false, true);
+			{
+				std::lock_guard<std::mutex> lock(state_mutex);
+				active_instances[worker_idx] = nullptr;
+				num_windows++;
+			}
+			if (!sat) continue;
+			instance->get_solution_from_backend();
+			if (!instance->solution_is_valid()) throw std::runtime_error("Solution is invalid (found bug) :-(");
+			instance->found_solution = true;
+			auto new_graph = instance->get_adder_graph();
+			auto new_full_adders = this->minimize_full_adders ? instance->count_full_adders() : FULL_ADDERS_UNLIMITED;
+			{
+				std::lock_guard<std::mutex> lock(state_mutex);
+				// another worker might have found something better in the meantime
+				if (new_graph.size() < best_graph.size() or (new_graph.size() == best_graph.size() and new_full_adders < best_full_adders)) {
+					best_graph = new_graph;
+					best_full_adders = new_full_adders;
+					best_version++;
+				}
+			}
+			state_cv.notify_all();
+		}
+	};
+	std::vector<std::thread> workers;
+	for (int i = 0; i < this->lns_workers; i++) {
+		workers.emplace_back([&, i]() {
+			try {
+				run_worker(i);
+			}
+			catch (...) {
+				std::lock_guard<std::mutex> lock(state_mutex);
+				if (error == nullptr) error = std::current_exception();
+			}
+			{
+				std::lock_guard<std::mutex> lock(state_mutex);
+				num_finished++;
+			}
+			state_cv.notify_all();
+		});
+	}
+	{
+		std::unique_lock<std::mutex> lock(state_mutex);
+		while (num_finished < this->lns_workers) {
+			state_cv.wait_for(lock, std::chrono::milliseconds(10));
+			if (reported_version < best_version) {
+				// take over the improvement in this thread so that the listener runs where this->solve() was called
+				reported_version = best_version;
+				this->set_adder_graph(best_graph);
+				std::cout << "  large neighbourhood search found solution for #adders = " << this->num_adders << (this->minimize_full_adders?" and "+std::to_string(best_full_adders)+" full adders":"") << std::endl;
+				if (this->minimize_full_adders) this->full_adder_upper_bound = best_full_adders;
+				this->num_add_opt = this->num_adders <= this->adder_lower_bound;
+				lock.unlock();
+				this->report_solution();
+				lock.lock();
+			}
+			if (error != nullptr or this->interrupt_requested or seconds_left() <= 0.0) {
+				stop = true;
+				// repeat this until the workers are done because a worker might not have started solving yet
+				for (auto &instance : active_instances) {
+					if (instance != nullptr) instance->interrupt();
+				}
+			}
+		}
+	}
+	for (auto &t : workers) {
+		t.join();
+	}
+	if (error != nullptr) std::rethrow_exception(error);
+	if (reported_version < best_version) {
+		this->set_adder_graph(best_graph);
+		if (this->minimize_full_adders) this->full_adder_upper_bound = best_full_adders;
+		this->num_add_opt = this->num_adders <= this->adder_lower_bound;
+		this->report_solution();
+	}
+	std::cout << "  large neighbourhood search solved " << num_windows << " windows and ended at #adders = " << this->num_adders << (this->minimize_full_adders?" and "+std::to_string(best_full_adders)+" full adders":"") << std::endl;
+}
+
+std::vector<std::vector<int>> scm::partition_constants() {
+	int max_bits = this->word_size - (this->calc_twos_complement?1:0);
+	// the requested constants that belong to each odd constant (e.g., 3 -> {3, -6})
+	std::map<int, std::vector<int>> requested;
+	for (auto &c : this->original_C) {
+		if (c == 0) continue;
+		auto odd = std::abs(c);
+		while ((odd & 1) == 0) odd /= 2;
+		if (odd != 1) requested[odd].emplace_back(c);
+	}
+	// the fundamentals that the heuristic needs for each constant on its own
+	std::map<int, std::set<int64_t>> fundamentals;
+	for (auto &c : this->C) {
+		for (auto &node : create_heuristic_adder_graph({c}, max_bits, this->max_shift)) {
+			fundamentals[c].insert(std::abs(node.value));
+		}
+	}
+	// start each cluster with the largest remaining constant (it has the most fundamentals to offer)
+	// and greedily add the constants that share most fundamentals with the cluster
+	std::vector<int> remaining(this->C.rbegin(), this->C.rend());
+	std::vector<std::vector<int>> clusters;
+	while (!remaining.empty()) {
+		std::vector<int> cluster = {remaining.front()};
+		auto shared = fundamentals[remaining.front()];
+		remaining.erase(remaining.begin());
+		while ((int)cluster.size() < this->max_cluster_size and !remaining.empty()) {
+			size_t best = 0;
+			int best_affinity = -1;
+			for (size_t i = 0; i < remaining.size(); i++) {
+				int affinity = 0;
+				for (auto &f : fundamentals[remaining[i]]) {
+					affinity += (int)shared.count(f);
+				}
+				if (affinity > best_affinity) {
+					best_affinity = affinity;
+					best = i;
+				}
+			}
+			cluster.emplace_back(remaining[best]);
+			shared.insert(fundamentals[remaining[best]].begin(), fundamentals[remaining[best]].end());
+			remaining.erase(remaining.begin()+best);
+		}
+		std::vector<int> cluster_constants;
+		for (auto &c : cluster) {
+			cluster_constants.insert(cluster_constants.end(), requested[c].begin(), requested[c].end());
+		}
+		clusters.emplace_back(cluster_constants);
+	}
+	return clusters;
+}
+
+void scm::partition_and_merge() {
+	auto clusters = this->partition_constants();
+	std::cout << "  split " << this->C.size() << " constants into " << clusters.size() << " clusters" << std::endl;
+	// the clusters get half of the budget and the large neighbourhood search gets the rest
+	double cluster_seconds = this->budget.is_limited() ? 0.5 * this->budget.get_slice(std::numeric_limits<double>::infinity()) : 0.0;
+	std::vector<std::unique_ptr<scm>> instances;
+	for (auto &cluster : clusters) {
+		auto instance = this->create_instance(cluster);
+		this->copy_settings_to(*instance);
+		instance->minimize_full_adders = this->minimize_full_adders;
+		instance->incremental_solving = this->incremental_solving;
+		instance->full_adder_search_strategy = this->full_adder_search_strategy;
+		instance->cache = this->cache;
+		// each cluster falls back to its own heuristic solution if it runs out of time
+		instance->use_heuristic = true;
+		instance->heuristic_graph.clear();
+		instance->budget = time_budget(cluster_seconds);
+		instances.emplace_back(std::move(instance));
+	}
+	std::mutex state_mutex;
+	std::condition_variable state_cv;
+	size_t num_finished = 0;
+	std::exception_ptr error = nullptr;
+	{
+		work_stealing_pool pool(this->partition_jobs);
+		for (auto &instance : instances) {
+			auto instance_ptr = instance.get();
+			pool.submit([&, instance_ptr]() {
+				try {
+					instance_ptr->solve();
+				}
+				catch (...) {
+					std::lock_guard<std::mutex> lock(state_mutex);
+					if (error == nullptr) error = std::current_exception();
+				}
+				{
+					std::lock_guard<std::mutex> lock(state_mutex);
+					num_finished++;
+				}
+				state_cv.notify_all();
+			});
+		}
+		std::unique_lock<std::mutex> lock(state_mutex);
+		while (num_finished < instances.size()) {
+			state_cv.wait_for(lock, std::chrono::milliseconds(10));
+			if (error != nullptr or this->interrupt_requested) {
+				// the clusters that are not done yet fall back to their heuristic solutions
+				for (auto &instance : instances) {
+					instance->interrupt();
+				}
+			}
+		}
+	}
+	if (error != nullptr) std::rethrow_exception(error);
+	// merge the cluster graphs and only keep the first node for each value
+	std::vector<adder_graph_node> merged;
+	std::map<int64_t, int> node_of_value = {{1, 0}};
+	for (auto &instance : instances) {
+		auto graph = instance->get_adder_graph();
+		if (graph.empty()) graph = create_heuristic_adder_graph(instance->C, this->word_size - (this->calc_twos_complement?1:0), this->max_shift);
+		std::vector<int> new_index(graph.size()+1, 0);
+		for (size_t i = 0; i < graph.size(); i++) {
+			auto node = graph[i];
+			auto it = node_of_value.find(node.value);
+			if (it != node_of_value.end()) {
+				new_index[i+1] = it->second;
+				continue;
+			}
+			node.left_input = new_index[node.left_input];
+			node.right_input = new_index[node.right_input];
+			merged.emplace_back(node);
+			new_index[i+1] = (int)merged.size();
+			node_of_value[node.value] = (int)merged.size();
+		}
+	}
+	std::cout << "  merged the cluster solutions into a solution for #adders = " << merged.size() << std::endl;
+	// the heuristic for all constants at once might still be better
+	if (this->heuristic_graph.empty() or merged.size() <= this->heuristic_graph.size()) this->heuristic_graph = merged;
+	if (!this->supports_assumptions()) {
+		std::cout << "Backend does not support assumptions -> skip the large neighbourhood search" << std::endl;
+		this->adder_lower_bound = this->num_adders+1;
+		this->set_adder_graph(this->heuristic_graph);
+		this->num_add_opt = this->num_adders <= this->adder_lower_bound;
+		this->num_FA_opt = false;
+		if (this->minimize_full_adders) {
+			this->full_adder_upper_bound = this->count_full_adders();
+			this->full_adder_lower_bound = -(this->num_adders * (this->max_shift+1));
+		}
+		this->report_solution();
+		return;
+	}
+	// find sharing between the clusters
+	this->lns_workers = std::max(1, this->lns_workers);
+	this->large_neighbourhood_search();
+}
+
+bool scm::bounded_adder_search() {
+	auto best_graph = this->heuristic_graph;
+	// counts below lower are infeasible or were skipped after a timeout
+	int lower = this->adder_lower_bound;
+	int upper = (int)best_graph.size();
+	bool solution_in_backend = false;
+	std::cout << "  searching #adders between " << lower << " and " << upper << (this->adder_search_strategy == adder_search::top_down_adder_search ? " top-down" : " with binary search") << std::endl;
+	while (lower < upper and !this->interrupt_requested and !this->budget.expired()) {
+		if (this->adder_search_strategy == adder_search::top_down_adder_search) {
+			this->num_adders = upper - 1;
 		}
 		else {
-			std::cout << "Current solution needs " << current_full_adders << " full adders" << std::endl;
-			this->print_solution();
+			this->num_adders = lower + (upper - 1 - lower) / 2;
 		}
-		// must add the number of MSBs that could not be cut because the SAT solver allocs an extra LUT for each of them
-		this->max_full_adders = current_full_adders - 1;
-		if (this->max_full_adders < -(this->num_adders * (this->max_shift+1))) {
-			// trivial minimum value reached
-			return;
+		if (this->restricted_instance != nullptr and this->solve_in_restricted_domain()) {
+			solution_in_backend = false;
 		}
-		this->optimization_loop(mode);
-		mode = formulation_mode::only_FA_limit;
-		if (this->ran_into_timeout) {
-			// timeout => can't say anything about optimality
-			this->num_FA_opt = false;
+		else {
+			this->optimization_loop(formulation_mode::reset_all);
+			solution_in_backend = this->found_solution;
+		}
+		if (this->found_solution) {
+			upper = this->num_adders;
+			best_graph = this->get_adder_graph();
+			this->report_solution();
+		}
+		else if (this->ran_into_timeout) {
+			// can't say anything about this count
+			if (this->adder_search_strategy == adder_search::top_down_adder_search) break;
+			lower = this->num_adders + 1;
 		}
+		else {
+			// fewer adders can't be feasible either
+			lower = this->num_adders + 1;
+			this->adder_lower_bound = std::max(this->adder_lower_bound, lower);
+		}
+	}
+	if (!solution_in_backend or this->num_adders != upper) {
+		std::cout << "  using best solution for #adders = " << upper << std::endl;
+		this->set_adder_graph(best_graph);
+		solution_in_backend = false;
+	}
+	this->found_solution = true;
+	this->ran_into_timeout = false;
+	this->num_add_opt = this->adder_lower_bound >= upper;
+	return solution_in_backend;
+}
+
+void scm::restrict_domain(int max_shift) {
+	// node values are limited to the bit width of the largest constant, i.e., to values < 2^ceil_log2(max(C)+1)
+	// (the full word size leaves room for one more bit)
+	int max_bits = 1;
+	for (auto &c : this->C) {
+		max_bits = std::max(max_bits, this->ceil_log2(c+1));
+	}
+	this->word_size = max_bits + (this->calc_twos_complement?1:0);
+	this->max_shift = std::max(1, std::min({max_shift, this->max_shift, max_bits-1}));
+	this->shift_word_size = this->ceil_log2(this->max_shift+1);
+}
+
+bool scm::solve_in_restricted_domain() {
+	// don't start another pass if we are supposed to stop anyway
+	if (this->interrupt_requested or this->budget.expired()) return false;
+	auto instance = this->restricted_instance.get();
+	instance->num_adders = this->num_adders;
+	instance->optimization_loop(this->restricted_mode);
+	if (this->incremental_solving) this->restricted_mode = formulation_mode::add_node;
+	if (!instance->found_solution) return false;
+	// all smaller adder counts were already checked in the full problem
+	std::cout << "  restricted domain pass found solution for #adders = " << this->num_adders << " -> skip the full problem" << std::endl;
+	this->set_adder_graph(instance->get_adder_graph());
+	return true;
+}
+
+std::vector<adder_graph_node> scm::get_adder_graph() {
+	std::vector<adder_graph_node> graph;
+	if (!this->found_solution) return graph;
+	for (int idx = 1; idx <= this->num_adders; idx++) {
+		adder_graph_node node;
+		node.left_input = this->input_select.at({idx, scm::left});
+		node.right_input = this->input_select.at({idx, scm::right});
+		node.shift = this->shift_value.at(idx);
+		node.negate_select = this->negate_select.at(idx);
+		node.subtract = this->subtract.at(idx);
+		if (this->enable_node_output_shift) node.post_adder_shift = this->post_adder_shift_value.at(idx);
+		node.value = this->output_values.at(idx);
+		graph.emplace_back(node);
+	}
+	return graph;
+}
+
+void scm::set_adder_graph(const std::vector<adder_graph_node> &graph) {
+	this->input_select.clear();
+	this->input_select_mux_output.clear();
+	this->shift_value.clear();
+	this->negate_select.clear();
+	this->subtract.clear();
+	this->post_adder_shift_value.clear();
+	this->add_result_values.clear();
+	this->output_values.clear();
+	this->num_adders = (int)graph.size();
+	this->output_values[0] = 1;
+	for (int idx = 1; idx <= this->num_adders; idx++) {
+		auto &node = graph[idx-1];
+		this->input_select[{idx, scm::left}] = node.left_input;
+		this->input_select[{idx, scm::right}] = node.right_input;
+		this->input_select_mux_output[{idx, scm::left}] = this->output_values.at(node.left_input);
+		this->input_select_mux_output[{idx, scm::right}] = this->output_values.at(node.right_input);
+		this->shift_value[idx] = node.shift;
+		this->negate_select[idx] = node.negate_select;
+		this->subtract[idx] = node.subtract;
+		this->post_adder_shift_value[idx] = node.post_adder_shift;
+		this->add_result_values[idx] = (int)(node.value * (((int64_t)1) << node.post_adder_shift));
+		this->output_values[idx] = (int)node.value;
 	}
 	this->found_solution = true;
+	this->ran_into_timeout = false;
+}
+
+bool scm::solve_from_table() {
+	if (this->C.size() != 1) return false;
+	// the table is only optimal for the settings it was generated with
+	auto flags = this->graph_table->get_flags();
+	bool sign_inversion = this->calc_twos_complement and this->sign_inversion_allowed[this->C[0]];
+	if (((flags & adder_graph_table::node_output_shift) != 0) != this->enable_node_output_shift) return false;
+	if (((flags & adder_graph_table::negative_numbers) != 0) != this->calc_twos_complement) return false;
+	if (this->minimize_full_adders and ((flags & adder_graph_table::minimize_full_adders) == 0 or sign_inversion)) return false;
+	adder_graph_table::entry e;
+	if (!this->graph_table->lookup(this->C[0], e)) return false;
+	if (!e.adders_optimal or (this->minimize_full_adders and !e.full_adders_optimal)) return false;
+	auto graph = parse_adder_graph_description(e.graph, this->enable_node_output_shift);
+	if ((int)graph.size() != e.num_adders or graph.empty() or graph.back().value != this->C[0]) {
+		std::cout << "  ignoring invalid table entry for constant " << this->C[0] << std::endl;
+		return false;
+	}
+	// the SAT search would never start below the requested minimum
+	if (e.num_adders < this->num_adders+1) return false;
+	std::cout << "  found solution for #adders = " << e.num_adders << " in adder graph table" << std::endl;
+	this->set_adder_graph(graph);
+	if (this->minimize_full_adders) {
+		this->full_adder_lower_bound = this->full_adder_upper_bound = this->count_full_adders();
+	}
+	else {
+		this->num_FA_opt = false;
+	}
+	return true;
+}
+
+std::string scm::get_cache_key() {
+	std::stringstream key;
+	key << "C=";
+	for (auto &c : this->C) {
+		key << c << (c == this->C.back() ? "" : ",");
+	}
+	key << ";sign_inversion=";
+	bool first = true;
+	for (auto &c : this->C) {
+		if (!this->sign_inversion_allowed[c]) continue;
+		key << (first ? "" : ",") << c;
+		first = false;
+	}
+	key << ";node_output_shift=" << this->enable_node_output_shift;
+	key << ";negative_numbers=" << this->calc_twos_complement;
+	key << ";minimize_full_adders=" << this->minimize_full_adders;
+	return key.str();
+}
+
+bool scm::solve_from_cache() {
+	result_cache::entry e;
+	if (!this->cache->load(this->get_cache_key(), e)) return false;
+	std::vector<adder_graph_node> graph;
+	try {
+		graph = parse_adder_graph_description(e.graph, this->enable_node_output_shift);
+	}
+	catch (std::runtime_error &) {
+		std::cout << "  ignoring invalid cache entry" << std::endl;
+		return false;
+	}
+	if ((int)graph.size() != e.num_adders or graph.empty()) {
+		std::cout << "  ignoring invalid cache entry" << std::endl;
+		return false;
+	}
+	if (e.adders_optimal() and e.num_adders >= this->num_adders+1 and (!this->minimize_full_adders or e.full_adders_optimal())) {
+		std::cout << "  found solution for #adders = " << e.num_adders << " in result cache" << std::endl;
+		this->set_adder_graph(graph);
+		this->adder_lower_bound = e.adder_lower_bound;
+		if (this->minimize_full_adders) {
+			this->full_adder_lower_bound = e.full_adder_lower_bound;
+			this->full_adder_upper_bound = e.full_adders;
+		}
+		else {
+			this->num_FA_opt = false;
+		}
+		return true;
+	}
+	// continue where the cached run stopped
+	std::cout << "  continuing cached result with #adders in [" << e.adder_lower_bound << ", " << e.num_adders << "]" << std::endl;
+	this->num_adders = std::max(this->num_adders, e.adder_lower_bound-1);
+	this->heuristic_graph = graph;
+	if (e.full_adders_known) {
+		this->cached_num_adders = e.num_adders;
+		this->cached_full_adder_lower_bound = e.full_adder_lower_bound;
+	}
+	return false;
+}
+
+void scm::store_in_cache() {
+	if (this->cache == nullptr or !this->found_solution) return;
+	result_cache::entry e;
+	e.graph = this->get_adder_graph_description();
+	e.num_adders = this->num_adders;
+	// the search only proves bounds above the one from set_min_add
+	e.adder_lower_bound = this->adder_lower_bound > this->min_add_lower_bound ? this->adder_lower_bound : std::min(this->adder_lower_bound, this->trivial_adder_lower_bound);
+	if (this->minimize_full_adders and this->full_adder_upper_bound != FULL_ADDERS_UNLIMITED) {
+		e.full_adders_known = true;
+		e.full_adders = this->full_adder_upper_bound;
+		e.full_adder_lower_bound = this->full_adder_lower_bound;
+	}
+	try {
+		this->cache->store(this->get_cache_key(), e);
+	}
+	catch (std::runtime_error &err) {
+		// a broken cache must not cost us the result
+		std::cout << "  failed to store result in cache: " << err.what() << std::endl;
+	}
+}
+
+void scm::seed_phases(formulation_mode mode) {
+	// use the best solution if there is one and the heuristic solution otherwise
+	// -> during full adder minimization, each search for a tighter limit starts at the last solution
+	auto graph = this->output_values.empty() ? this->heuristic_graph : this->get_adder_graph();
+	auto set_phases = [&](auto &variables, auto key_of_bit, int64_t value, int num_bits) {
+		for (int w = 0; w < num_bits; w++) {
+			auto it = variables.find(key_of_bit(w));
+			if (it == variables.end()) continue;
+			this->set_preferred_phase(it->second, ((value >> w) & 1) == 1);
+		}
+	};
+	int first_node = mode == formulation_mode::add_node ? this->num_adders : 1;
+	int last_node = std::min(this->num_adders, (int)graph.size());
+	for (int idx = first_node; idx <= last_node; idx++) {
+		auto &node = graph[idx-1];
+		set_phases(this->output_value_variables, [&](int w) { return std::make_pair(idx, w); }, node.value, this->word_size);
+		set_phases(this->adder_output_value_variables, [&](int w) { return std::make_pair(idx, w); }, node.value * (((int64_t)1) << node.post_adder_shift), this->word_size);
+		set_phases(this->input_shift_value_variables, [&](int w) { return std::make_pair(idx, w); }, node.shift, this->shift_word_size);
+		set_phases(this->input_select_selection_variables, [&](int w) { return std::make_tuple(idx, scm::left, w); }, node.left_input, this->word_size);
+		set_phases(this->input_select_selection_variables, [&](int w) { return std::make_tuple(idx, scm::right, w); }, node.right_input, this->word_size);
+		set_phases(this->input_negate_select_variables, [&](int) { return idx; }, node.negate_select, 1);
+		set_phases(this->input_negate_value_variables, [&](int) { return idx; }, node.subtract, 1);
+		if (this->enable_node_output_shift) {
+			set_phases(this->input_post_adder_shift_value_variables, [&](int w) { return std::make_pair(idx, w); }, node.post_adder_shift, this->shift_word_size);
+		}
+	}
+}
+
+void scm::copy_settings_to(scm &other) const {
+	other.enable_node_output_shift = this->enable_node_output_shift;
+	other.sign_inversion_allowed = this->sign_inversion_allowed;
+	other.random_seed = this->random_seed;
+	other.heuristic_graph = this->heuristic_graph;
+	other.symmetry_breaking = this->symmetry_breaking;
+	other.cnf_format = this->cnf_format;
+	other.graph_table = this->graph_table;
+	other.budget = this->budget;
+}
+
+void scm::copy_solution_from(const scm &other) {
+	this->input_select = other.input_select;
+	this->input_select_mux_output = other.input_select_mux_output;
+	this->shift_value = other.shift_value;
+	this->negate_select = other.negate_select;
+	this->subtract = other.subtract;
+	this->post_adder_shift_value = other.post_adder_shift_value;
+	this->add_result_values = other.add_result_values;
+	this->output_values = other.output_values;
+	this->coeff_word_size_values = other.coeff_word_size_values;
+	this->can_cut_msb_values = other.can_cut_msb_values;
+	this->coeff_word_size_sum_values = other.coeff_word_size_sum_values;
+	this->shift_gain_values = other.shift_gain_values;
+	this->shift_sum_values = other.shift_sum_values;
+	this->num_FAs_value = other.num_FAs_value;
 }
 
 void scm::reset_backend(formulation_mode mode) {
 	if (mode != formulation_mode::reset_all) return;
 	this->constraint_counter = 0;
 	this->variable_counter = 0;
-	this->cnf_clauses.str("");
+	if (this->write_cnf) this->cnf = std::make_unique<cnf_writer>(this->cnf_format);
+	// forget the variables of the last problem (the variable maps keep their memory)
+	this->input_select_mux_variables.clear();
+	this->input_select_mux_output_variables.clear();
+	this->input_select_selection_variables.clear();
+	this->input_shift_value_variables.clear();
+	this->shift_internal_mux_output_variables.clear();
+	this->shift_output_variables.clear();
+	this->input_negate_select_variables.clear();
+	this->negate_select_output_variables.clear();
+	this->input_negate_value_variables.clear();
+	this->xor_output_variables.clear();
+	this->adder_carry_variables.clear();
+	this->adder_XOR_internal_variables.clear();
+	this->adder_output_value_variables.clear();
+	this->input_post_adder_shift_value_variables.clear();
+	this->post_adder_shift_internal_mux_output_variables.clear();
+	this->post_adder_shift_output_variables.clear();
+	this->output_value_variables.clear();
+	this->full_adder_coeff_word_size_variables.clear();
+	this->full_adder_coeff_word_size_internal_variables.clear();
+	this->full_adder_coeff_word_size_internal_carry_input_variables.clear();
+	this->full_adder_msb_variables.clear();
+	this->full_adder_word_size_sum_variables.clear();
+	this->full_adder_shift_gain_variables.clear();
+	this->full_adder_shift_sum_variables.clear();
+	this->full_adder_msb_sum_variables.clear();
+	this->full_adder_add_subtract_inputs_variables.clear();
+	this->full_adder_cpa_internal_variables.clear();
+	this->full_adder_result_variables.clear();
+	this->full_adder_comparator_ok_variables.clear();
+	this->full_adder_comparator_carry_variables.clear();
+	this->full_adder_limit_variables.clear();
+	this->full_adder_limit_le_variables.clear();
+	this->mcm_output_variables.clear();
 }
 
 void scm::construct_problem(formulation_mode mode) {
-	if (mode == formulation_mode::reset_all) {
-		// only construct new variables in non-incremental mode
+	if (mode == formulation_mode::reset_all or mode == formulation_mode::add_node) {
+		// only construct new variables in non-incremental mode or for a new node
 		if (!this->quiet) std::cout << "    creating variables now" << std::endl;
-		this->create_variables();
+		this->create_variables(mode);
 	}
 	if (!this->quiet) std::cout << "    creating constraints now" << std::endl;
 	this->create_constraints(mode);
+	this->collect_assumptions();
 	if (this->write_cnf) {
 		if (!this->quiet) std::cout << "    creating cnf file now" << std::endl;
 		this->create_cnf_file();
 	}
 }
 
-void scm::create_variables() {
-	if (!this->quiet) std::cout << "      creating input node variables" << std::endl;
-	this->create_input_node_variables();
-	for (int i=1; i<=this->num_adders; i++) {
+void scm::create_variables(formulation_mode mode) {
+	int first_node = this->num_adders;
+	if (mode == formulation_mode::reset_all) {
+		if (!this->quiet) std::cout << "      creating input node variables" << std::endl;
+		this->create_input_node_variables();
+		first_node = 1;
+	}
+	for (int i=first_node; i<=this->num_adders; i++) {
 		if (!this->quiet) std::cout << "      creating variables for node " << i << std::endl;
 		if (!this->quiet) std::cout << "        create_input_select_mux_variables" << std::endl;
 		this->create_input_select_mux_variables(i);
@@ -260,43 +1406,54 @@ void scm::create_variables() {
 void scm::create_constraints(formulation_mode mode) {
 	if (!this->quiet) std::cout << "      create_input_output_constraints" << std::endl;
 	this->create_input_output_constraints(mode);
-	for (int i=1; i<=this->num_adders; i++) {
+	int first_node = 1;
+	formulation_mode node_mode = mode;
+	if (mode == formulation_mode::add_node) {
+		// all other nodes are already part of the problem -> create all clauses for the new one
+		first_node = this->num_adders;
+		node_mode = formulation_mode::reset_all;
+	}
+	for (int i=first_node; i<=this->num_adders; i++) {
 		if (!this->quiet) std::cout << "      creating constraints for node " << i << std::endl;
 		if (!this->quiet) std::cout << "        create_input_select_constraints" << std::endl;
-		this->create_input_select_constraints(i, mode);
+		this->create_input_select_constraints(i, node_mode);
 		if (!this->quiet) std::cout << "        create_input_select_limitation_constraints" << std::endl;
-		this->create_input_select_limitation_constraints(i, mode);
+		this->create_input_select_limitation_constraints(i, node_mode);
 		if (!this->quiet) std::cout << "        create_shift_limitation_constraints" << std::endl;
-		this->create_shift_limitation_constraints(i, mode);
+		this->create_shift_limitation_constraints(i, node_mode);
 		if (!this->quiet) std::cout << "        create_shift_constraints" << std::endl;
-		this->create_shift_constraints(i, mode);
+		this->create_shift_constraints(i, node_mode);
 		if (!this->quiet) std::cout << "        create_negate_select_constraints" << std::endl;
-		this->create_negate_select_constraints(i, mode);
+		this->create_negate_select_constraints(i, node_mode);
 		if (!this->quiet) std::cout << "        create_xor_constraints" << std::endl;
-		this->create_xor_constraints(i, mode);
+		this->create_xor_constraints(i, node_mode);
 		if (!this->quiet) std::cout << "        create_adder_constraints" << std::endl;
-		this->create_adder_constraints(i, mode);
+		this->create_adder_constraints(i, node_mode);
 		if (!this->quiet) std::cout << "        create_odd_fundamentals_constraints" << std::endl;
-		this->create_odd_fundamentals_constraints(i, mode);
+		this->create_odd_fundamentals_constraints(i, node_mode);
 		if (this->enable_node_output_shift) {
 			if (!this->quiet) std::cout << "        create_post_adder_shift_limitation_constraints" << std::endl;
-			this->create_post_adder_shift_limitation_constraints(i, mode);
+			this->create_post_adder_shift_limitation_constraints(i, node_mode);
 			if (!this->quiet) std::cout << "        create_post_adder_shift_constraints" << std::endl;
-			this->create_post_adder_shift_constraints(i, mode);
+			this->create_post_adder_shift_constraints(i, node_mode);
 		}
 		if (this->max_full_adders != FULL_ADDERS_UNLIMITED) {
 			if (!this->quiet) std::cout << "        create_full_adder_coeff_word_size_constraints" << std::endl;
-			this->create_full_adder_coeff_word_size_constraints(i, mode);
+			this->create_full_adder_coeff_word_size_constraints(i, node_mode);
 			if (!this->quiet) std::cout << "        create_full_adder_msb_constraints" << std::endl;
-			this->create_full_adder_msb_constraints(i, mode);
+			this->create_full_adder_msb_constraints(i, node_mode);
 			if (!this->quiet) std::cout << "        create_full_adder_coeff_word_size_sum_constraints" << std::endl;
-			this->create_full_adder_coeff_word_size_sum_constraints(i, mode);
+			this->create_full_adder_coeff_word_size_sum_constraints(i, node_mode);
 			if (!this->quiet) std::cout << "        create_full_adder_shift_gain_constraints" << std::endl;
-			this->create_full_adder_shift_gain_constraints(i, mode);
+			this->create_full_adder_shift_gain_constraints(i, node_mode);
 			if (!this->quiet) std::cout << "        create_full_adder_shift_sum_constraints" << std::endl;
-			this->create_full_adder_shift_sum_constraints(i, mode);
+			this->create_full_adder_shift_sum_constraints(i, node_mode);
 		}
 	}
+	if (this->symmetry_breaking) {
+		if (!this->quiet) std::cout << "      create_symmetry_breaking_constraints" << std::endl;
+		this->create_symmetry_breaking_constraints(mode);
+	}
 	if (this->max_full_adders != FULL_ADDERS_UNLIMITED) {
 		if (!this->quiet) std::cout << "        create_full_adder_msb_sum_constraints" << std::endl;
 		this->create_full_adder_msb_sum_constraints(mode);
@@ -304,8 +1461,15 @@ void scm::create_constraints(formulation_mode mode) {
 		this->create_full_adder_add_subtract_inputs_constraints(mode);
 		if (!this->quiet) std::cout << "        create_full_adder_cpa_constraints" << std::endl;
 		this->create_full_adder_cpa_constraints(mode);
-		if (!this->quiet) std::cout << "        create_full_adder_result_constraints" << std::endl;
-		this->create_full_adder_result_constraints();
+		if (this->supports_assumptions()) {
+			if (!this->quiet) std::cout << "        create_full_adder_limit_constraints" << std::endl;
+			this->create_full_adder_limit_constraints(mode);
+		}
+		else {
+			// fall back to a new comparator against the constant limit for each FA iteration
+			if (!this->quiet) std::cout << "        create_full_adder_result_constraints" << std::endl;
+			this->create_full_adder_result_constraints();
+		}
 	}
 }
 
@@ -470,13 +1634,24 @@ void scm::create_new_variable(int idx) {
 	(void) idx; // just do nothing -> should be overloaded by backend if a variable must be explicitly created
 }
 
-void scm::create_arbitrary_clause(const std::vector<std::pair<int, bool>> &a) {
-	this->constraint_counter++;
-	if (!this->write_cnf) return;
+void scm::add_clause_to_backend(const int *literals, int num_literals) {
+	(void) literals;
+	(void) num_literals;
+	throw std::runtime_error("add_clause_to_backend is impossible in base class");
+}
+
+void scm::create_arbitrary_clause(std::initializer_list<std::pair<int, bool>> a) {
+	this->clause_buffer.clear();
 	for (const auto &it : a) {
-		this->cnf_clauses << (it.second?-it.first:it.first) << " ";
+		this->clause_buffer.emplace_back(it.second?-it.first:it.first);
 	}
-	this->cnf_clauses << " 0" << std::endl;
+	this->create_clause(this->clause_buffer.data(), (int)this->clause_buffer.size());
+}
+
+void scm::create_clause(const int *literals, int num_literals) {
+	this->constraint_counter++;
+	if (this->cnf != nullptr) this->cnf->add_clause(literals, num_literals);
+	this->add_clause_to_backend(literals, num_literals);
 }
 
 void scm::create_signed_shift_overflow_protection(int sel, int s_a, int a) {
@@ -498,13 +1673,7 @@ void scm::create_signed_add_overflow_protection(int sub, int s_a, int s_b, int s
 }
 
 void scm::create_or(std::vector<int> &x) {
-	std::vector<std::pair<int, bool>> v(x.size());
-	for (auto i=0; i<x.size(); i++) {
-		auto &val = x[i];
-		if (val > 0) v[i] = {val, false};
-		else v[i] = {-val, true};
-	}
-	this->create_arbitrary_clause(v);
+	this->create_clause(x.data(), (int)x.size());
 }
 
 void scm::create_1x1_implication(int a, int b) {
@@ -520,23 +1689,18 @@ void scm::create_1x1_reversed_negated_implication(int a, int b) {
 }
 
 void scm::create_1xN_implication(int a, const std::vector<int> &b) {
-	std::vector<std::pair<int, bool>> v(b.size()+1);
-	for (auto i=0; i<b.size(); i++) {
-		v[i] = {b[i], false};
-	}
-	v[b.size()] = {a, true};
-	this->create_arbitrary_clause(v);
+	this->clause_buffer.assign(b.begin(), b.end());
+	this->clause_buffer.emplace_back(-a);
+	this->create_clause(this->clause_buffer.data(), (int)this->clause_buffer.size());
 }
 
 void scm::create_MxN_implication(const std::vector<int> &a, const std::vector<int> &b) {
-	std::vector<std::pair<int, bool>> v(b.size()+a.size());
-	for (auto i=0; i<a.size(); i++) {
-		v[i] = {a[i], true};
-	}
-	for (auto i=0; i<b.size(); i++) {
-		v[i+a.size()] = {b[i], false};
+	this->clause_buffer.clear();
+	for (auto &it : a) {
+		this->clause_buffer.emplace_back(-it);
 	}
-	this->create_arbitrary_clause(v);
+	this->clause_buffer.insert(this->clause_buffer.end(), b.begin(), b.end());
+	this->create_clause(this->clause_buffer.data(), (int)this->clause_buffer.size());
 }
 
 void scm::create_1x1_equivalence(int x, int y) {
@@ -689,17 +1853,30 @@ void scm::force_bit(int x, int val) {
 
 void scm::forbid_number(const std::vector<int> &x, int val) {
 	auto num_bits = (int)x.size();
-	std::vector<std::pair<int, bool>> v(num_bits);
+	this->clause_buffer.clear();
 	for (int i=0; i<num_bits; i++) {
 		auto bit = (val >> i) & 1;
 		if (bit == 1) {
-			v[i] = {x[i], true};
+			this->clause_buffer.emplace_back(-x[i]);
 		}
 		else {
-			v[i] = {x[i], false};
+			this->clause_buffer.emplace_back(x[i]);
+		}
+	}
+	this->create_clause(this->clause_buffer.data(), (int)this->clause_buffer.size());
+}
+
+void scm::force_number_if(int a, const std::vector<int> &x, int val) {
+	auto num_bits = (int)x.size();
+	for (int i=0; i<num_bits; i++) {
+		auto bit = (val >> i) & 1;
+		if (bit == 1) {
+			this->create_arbitrary_clause({{a, true}, {x[i], false}});
+		}
+		else {
+			this->create_arbitrary_clause({{a, true}, {x[i], true}});
 		}
 	}
-	this->create_arbitrary_clause(v);
 }
 
 void scm::force_number(const std::vector<int> &x, int val) {
@@ -723,19 +1900,133 @@ int scm::get_result_value(int var_idx) {
 	throw std::runtime_error("get_result_value is impossible in base class");
 }
 
+bool scm::supports_assumptions() {
+	return false;
+}
+
+std::unique_ptr<scm> scm::create_instance(const std::vector<int> &C) {
+	(void) C;
+	throw std::runtime_error("create_instance is impossible in base class");
+}
+
+void scm::interrupt_backend() {
+	// nothing to do -> should be overloaded by backend if it can be stopped from another thread
+}
+
+void scm::interrupt() {
+	this->interrupt_requested = true;
+	this->interrupt_backend();
+	std::lock_guard<std::mutex> lock(this->restricted_instance_mutex);
+	if (this->restricted_instance != nullptr) this->restricted_instance->interrupt();
+}
+
+void scm::set_random_seed(int seed) {
+	this->random_seed = seed;
+}
+
+void scm::share_learned_clauses(std::shared_ptr<clause_exchange> exchange) {
+	this->learned_clause_exchange = std::move(exchange);
+}
+
+void scm::load_cnf(int num_variables, const std::vector<int> &clauses) {
+	this->reset_backend(formulation_mode::reset_all);
+	this->cnf_assumptions_forced = false;
+	this->extend_cnf(num_variables, clauses.data(), clauses.size());
+}
+
+bool scm::extend_cnf(int num_variables, const int *clauses, size_t num_literals) {
+	if (this->cnf_assumptions_forced) return false;
+	this->interrupt_requested = false;
+	for (int idx = this->variable_counter+1; idx <= num_variables; idx++) {
+		this->create_new_variable(idx);
+	}
+	this->variable_counter = std::max(this->variable_counter, num_variables);
+	// pass the clauses directly from the flat buffer
+	size_t clause_start = 0;
+	for (size_t i = 0; i < num_literals; i++) {
+		if (clauses[i] != 0) continue;
+		this->create_clause(clauses+clause_start, (int)(i-clause_start));
+		clause_start = i+1;
+	}
+	return true;
+}
+
+std::pair<bool, bool> scm::solve_cnf(const std::vector<std::pair<int, bool>> &cnf_assumptions, double cnf_timeout) {
+	this->check_timeout = cnf_timeout;
+	this->assumptions = cnf_assumptions;
+	if (!this->supports_assumptions()) {
+		// the loaded problem is only solved once -> we can simply force all assumptions
+		for (auto &it : this->assumptions) {
+			this->create_arbitrary_clause({it});
+		}
+		this->cnf_assumptions_forced = !this->assumptions.empty();
+		this->assumptions.clear();
+	}
+	return this->check();
+}
+
+int scm::get_cnf_value(int var_idx) {
+	return this->get_result_value(var_idx);
+}
+
+bool scm::cnf_assumption_failed(const std::pair<int, bool> &assumption) {
+	return this->assumption_failed(assumption);
+}
+
+void scm::set_cnf_phase(int var_idx, bool value) {
+	this->set_preferred_phase(var_idx, value);
+}
+
+void scm::set_preferred_phase(int var_idx, bool value) {
+	(void) var_idx;
+	(void) value;
+	// nothing to do -> should be overloaded by backend if it supports phases
+}
+
+bool scm::assumption_failed(const std::pair<int, bool> &assumption) {
+	(void) assumption;
+	// we don't know the UNSAT core -> assume that everything was needed
+	return true;
+}
+
+void scm::collect_assumptions() {
+	this->assumptions.clear();
+	if (this->incremental_solving) {
+		this->assumptions.emplace_back(this->output_activation_variable, false);
+	}
+	if (this->max_full_adders != FULL_ADDERS_UNLIMITED and !this->full_adder_limit_variables.empty()) {
+		// set the bits of the full adder limit
+		for (auto &it : this->full_adder_limit_variables) {
+			this->assumptions.emplace_back(it.second, ((this->max_full_adders >> it.first) & 1) == 0);
+		}
+	}
+}
+
 void scm::create_input_output_constraints(formulation_mode mode) {
-	if (mode != formulation_mode::reset_all) return;
+	if (mode != formulation_mode::reset_all and mode != formulation_mode::add_node) return;
 	std::vector<int> input_bits(this->word_size);
 	std::vector<int> output_bits(this->word_size);
 	for (auto w=0; w<this->word_size; w++) {
-		input_bits[w] = this->output_value_variables.at({0, w});
+		if (mode == formulation_mode::reset_all) input_bits[w] = this->output_value_variables.at({0, w});
 		output_bits[w] = this->output_value_variables.at({this->num_adders, w});
 	}
 	// force input to 1 and output to C
-	this->force_number(input_bits, 1);
+	if (mode == formulation_mode::reset_all) this->force_number(input_bits, 1);
+	if (this->incremental_solving) {
+		// the output constraints of the last number of adders must not hold anymore
+		if (mode == formulation_mode::add_node) this->force_bit(this->output_activation_variable, 0);
+		// and the new ones only hold while we assume the activation variable
+		this->output_activation_variable = ++this->variable_counter;
+		this->create_new_variable(this->variable_counter);
+	}
 	if (this->C.size() == 1 and (!this->calc_twos_complement or !this->sign_inversion_allowed[this->C[0]])) {
 		// SCM
-		this->force_number(output_bits, this->C[0]);
+		if (this->incremental_solving) {
+			this->force_number_if(this->output_activation_variable, output_bits, this->C[0]);
+		}
+		else {
+			this->force_number(output_bits, this->C[0]);
+		}
 	}
 	else {
 		// MCM
@@ -1158,6 +2449,11 @@ void scm::get_solution_from_backend() {
 					}
 				}
 			}
+			else {
+				// the first node can only use the input node
+				this->input_select[{idx, scm::left}] = 0;
+				this->input_select[{idx, scm::right}] = 0;
+			}
 			// shift_value
 			for (auto w = 0; w < this->shift_word_size; w++) {
 				this->shift_value[idx] += (this->get_result_value(this->input_shift_value_variables[{idx, w}]) << w);
@@ -1541,7 +2837,6 @@ bool scm::solution_is_valid() {
 }
 
 void scm::create_cnf_file() {
-	std::ofstream f;
 	std::stringstream constants;
 	for (int i=0; i<this->C.size(); i++) {
 		if (i != 0) constants << "_";
@@ -1549,23 +2844,186 @@ void scm::create_cnf_file() {
 	}
 	std::string filename;
 	if (this->max_full_adders != FULL_ADDERS_UNLIMITED) {
-		filename = constants.str() + "-" + std::to_string(this->num_adders) + "-" + std::to_string(this->max_full_adders) + ".cnf";
+		filename = constants.str() + "-" + std::to_string(this->num_adders) + "-" + std::to_string(this->max_full_adders);
 	}
 	else {
-		filename = constants.str() + "-" + std::to_string(this->num_adders) + ".cnf";
+		filename = constants.str() + "-" + std::to_string(this->num_adders);
+	}
+	filename += "." + cnf_writer::get_extension(this->cnf_format);
+	// assumptions become unit clauses
+	std::vector<int> unit_literals;
+	for (auto &it : this->assumptions) {
+		unit_literals.emplace_back(it.second?-it.first:it.first);
+	}
+	this->cnf->write_file(filename, this->variable_counter, unit_literals);
+	this->write_variable_map(get_variable_map_filename(filename));
+}
+
+std::string scm::get_variable_map_filename(const std::string &cnf_filename) {
+	auto base = cnf_reader::strip_extension(cnf_filename);
+	if (base.empty()) throw std::runtime_error("unknown CNF format of "+cnf_filename);
+	return base + ".map";
+}
+
+void scm::write_variable_map(const std::string &filename) {
+	std::ofstream f(filename, std::ios::trunc);
+	f << "satscm_variable_map 1" << std::endl;
+	f << "original_constants";
+	for (auto &c : this->original_C) {
+		f << " " << c;
+	}
+	f << std::endl;
+	f << "allow_negative_numbers " << this->calc_twos_complement << std::endl;
+	f << "num_adders " << this->num_adders << std::endl;
+	f << "word_size " << this->word_size << std::endl;
+	f << "shift_word_size " << this->shift_word_size << std::endl;
+	f << "max_shift " << this->max_shift << std::endl;
+	f << "node_output_shift " << this->enable_node_output_shift << std::endl;
+	f << "max_full_adders " << this->max_full_adders << std::endl;
+	f << "sign_inversion_allowed";
+	for (auto &it : this->sign_inversion_allowed) {
+		f << " " << it.first << " " << it.second;
+	}
+	f << std::endl;
+	// one line per variable: < name, key..., variable idx >
+	this->for_each_variable_map([&](const char *name, auto &variables) {
+		using key = variable_map_key<typename std::decay_t<decltype(variables)>::key_type>;
+		for (auto &it : variables) {
+			f << name;
+			for (auto &i : key::to_indices(it.first)) {
+				f << " " << i;
+			}
+			f << " " << it.second << "\n";
+		}
+	});
+	if (!f) throw std::runtime_error("failed to write "+filename);
+}
+
+std::pair<std::vector<int>, bool> scm::read_cnf_problem(const std::string &cnf_filename) {
+	auto filename = get_variable_map_filename(cnf_filename);
+	std::ifstream f(filename);
+	if (!f) throw std::runtime_error("failed to open "+filename);
+	std::vector<int> constants;
+	int allow_negative_numbers = -1;
+	std::string line;
+	while (std::getline(f, line) and (constants.empty() or allow_negative_numbers < 0)) {
+		std::stringstream s(line);
+		std::string name;
+		s >> name;
+		if (name == "original_constants") {
+			int c;
+			while (s >> c) constants.emplace_back(c);
+		}
+		else if (name == "allow_negative_numbers") s >> allow_negative_numbers;
+	}
+	if (constants.empty() or allow_negative_numbers < 0) throw std::runtime_error("invalid variable map file "+filename);
+	return {constants, allow_negative_numbers == 1};
+}
+
+void scm::read_variable_map(const std::string &filename) {
+	std::ifstream f(filename);
+	if (!f) throw std::runtime_error("failed to open "+filename);
+	std::map<std::string, std::function<void(std::stringstream &)>> variable_readers;
+	this->for_each_variable_map([&](const char *name, auto &variables) {
+		variable_readers[name] = [&variables](std::stringstream &s) {
+			using key = variable_map_key<typename std::decay_t<decltype(variables)>::key_type>;
+			std::array<int, key::dimensions> indices;
+			for (auto &i : indices) {
+				s >> i;
+			}
+			int var = 0;
+			s >> var;
+			if (!s or var <= 0) throw std::runtime_error("invalid variable index");
+			variables[key::from_indices(indices)] = var;
+		};
+	});
+	std::string line;
+	std::getline(f, line);
+	if (line != "satscm_variable_map 1") throw std::runtime_error(filename+" is not a satscm variable map file");
+	while (std::getline(f, line)) {
+		std::stringstream s(line);
+		std::string name;
+		if (!(s >> name)) continue;
+		auto reader = variable_readers.find(name);
+		try {
+			if (reader != variable_readers.end()) reader->second(s);
+			else if (name == "original_constants") {
+				std::vector<int> constants;
+				int c;
+				while (s >> c) constants.emplace_back(c);
+				if (constants != this->original_C) throw std::runtime_error("the constants do not match");
+			}
+			else if (name == "allow_negative_numbers") {
+				bool allow_negative_numbers;
+				s >> allow_negative_numbers;
+				if (allow_negative_numbers != this->calc_twos_complement) throw std::runtime_error("the number representation does not match");
+			}
+			else if (name == "num_adders") s >> this->num_adders;
+			else if (name == "word_size") s >> this->word_size;
+			else if (name == "shift_word_size") s >> this->shift_word_size;
+			else if (name == "max_shift") s >> this->max_shift;
+			else if (name == "node_output_shift") s >> this->enable_node_output_shift;
+			else if (name == "max_full_adders") s >> this->max_full_adders;
+			else if (name == "sign_inversion_allowed") {
+				int c;
+				bool allowed;
+				while (s >> c >> allowed) this->sign_inversion_allowed[c] = allowed;
+			}
+			else throw std::runtime_error("unknown entry");
+			if (s.fail() and !s.eof()) throw std::runtime_error("invalid value");
+		}
+		catch (std::runtime_error &e) {
+			throw std::runtime_error("failed to read '"+line+"' in "+filename+": "+e.what());
+		}
+	}
+}
+
+void scm::solve_cnf_file(const std::string &cnf_filename) {
+	// a single SAT problem can't prove anything about other adder or full adder counts
+	this->num_add_opt = false;
+	this->num_FA_opt = false;
+	auto start_time = std::chrono::steady_clock::now();
+	{
+		int num_variables;
+		std::vector<int> clauses;
+		cnf_reader::read_file(cnf_filename, num_variables, clauses);
+		this->load_cnf(num_variables, clauses);
+	}
+	// the backend reset in load_cnf forgets all variables -> restore them afterwards
+	this->read_variable_map(get_variable_map_filename(cnf_filename));
+	this->assumptions.clear();
+	if (!this->quiet) std::cout << "  start solving " << cnf_filename << " with " << this->variable_counter << " variables and " << this->constraint_counter << " constraints" << std::endl;
+	auto [a, b] = this->check();
+	auto elapsed_time = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_time).count() / 1000.0;
+	this->found_solution = a;
+	this->ran_into_timeout = b;
+	if (this->found_solution) {
+		std::cout << "  found solution for #adders = " << this->num_adders << (this->max_full_adders!=FULL_ADDERS_UNLIMITED?" and max. "+std::to_string(this->max_full_adders)+" full adders":"") << " after " << elapsed_time << " seconds 8-)" << std::endl;
+		this->get_solution_from_backend();
+		if (this->solution_is_valid()) {
+			std::cout << "Solution is verified :-)" << std::endl;
+		}
+		else {
+			throw std::runtime_error("Solution is invalid (the variable map does not match the CNF file?) :-(");
+		}
+	}
+	else if (this->ran_into_timeout) {
+		std::cout << "  ran into timeout for " << cnf_filename << " after " << elapsed_time << " seconds :-(" << std::endl;
+	}
+	else {
+		std::cout << "  " << cnf_filename << " is proven to be infeasible after " << elapsed_time << " seconds" << std::endl;
 	}
-	f.open(filename.c_str());
-	f << "p cnf " << this->variable_counter << " " << this->constraint_counter << std::endl;
-	f << this->cnf_clauses.str();
-	f.close();
 }
 
 void scm::create_mcm_output_constraints(formulation_mode mode) {
-	if (mode != formulation_mode::reset_all) return;
+	if (mode != formulation_mode::reset_all and mode != formulation_mode::add_node) return;
+	// in incremental mode, only the new node needs clauses for its outputs
+	int first_node = mode == formulation_mode::add_node ? this->num_adders : 1;
 	for (auto &c : this->C) {
 		std::vector<int> or_me;
 		for (int idx = 1; idx <= this->num_adders; idx++) {
 			or_me.emplace_back(this->mcm_output_variables[{idx, c}]);
+			if (idx < first_node) continue;
 			for (int w = 0; w < this->word_size; w++) {
 				if (((c >> w) & 1) == 1) {
 					this->create_1x1_implication(this->mcm_output_variables[{idx, c}], this->output_value_variables[{idx, w}]);
@@ -1579,6 +3037,7 @@ void scm::create_mcm_output_constraints(formulation_mode mode) {
 			// also allow the solver to choose -c instead of c if it's easier to implement
 			for (int idx = 1; idx <= this->num_adders; idx++) {
 				or_me.emplace_back(this->mcm_output_variables[{idx, -c}]);
+				if (idx < first_node) continue;
 				for (int w = 0; w < this->word_size; w++) {
 					if ((((-c) >> w) & 1) == 1) {
 						this->create_1x1_implication(this->mcm_output_variables[{idx, -c}], this->output_value_variables[{idx, w}]);
@@ -1589,6 +3048,10 @@ void scm::create_mcm_output_constraints(formulation_mode mode) {
 				}
 			}
 		}
+		if (this->incremental_solving) {
+			// only require c as an output while the activation variable is assumed
+			or_me.emplace_back(-this->output_activation_variable);
+		}
 		this->create_or(or_me);
 	}
 }
@@ -1609,6 +3072,98 @@ void scm::create_odd_fundamentals_constraints(int idx, formulation_mode mode) {
 	this->force_bit(this->output_value_variables.at({idx,0}), 1);
 }
 
+void scm::create_symmetry_breaking_constraints(formulation_mode mode) {
+	if (mode != formulation_mode::reset_all and mode != formulation_mode::add_node) return;
+	int first_node = mode == formulation_mode::add_node ? this->num_adders : 1;
+	auto get_output_bits = [&](int idx) {
+		std::vector<int> bits(this->word_size);
+		for (int w = 0; w < this->word_size; w++) {
+			bits[w] = this->output_value_variables.at({idx, w});
+		}
+		return bits;
+	};
+	for (int idx = first_node; idx <= this->num_adders; idx++) {
+		// (a << s) + b = b + (a << s) -> only allow the first form
+		this->create_1x1_reversed_negated_implication(this->input_negate_value_variables.at(idx), this->input_negate_select_variables.at(idx));
+		// no duplicate fundamentals: at least one bit must differ (except for the LSB which is always 1)
+		auto bits = get_output_bits(idx);
+		for (int other_idx = 1; other_idx < idx; other_idx++) {
+			auto other_bits = get_output_bits(other_idx);
+			std::vector<int> or_me;
+			for (int w = 1; w < this->word_size; w++) {
+				auto differs = ++this->variable_counter;
+				this->create_new_variable(differs);
+				this->create_arbitrary_clause({{differs, true}, {bits[w], false}, {other_bits[w], false}});
+				this->create_arbitrary_clause({{differs, true}, {bits[w], true}, {other_bits[w], true}});
+				or_me.emplace_back(differs);
+			}
+			this->create_or(or_me);
+		}
+	}
+	// nodes that do not depend on their predecessor can be swapped with it -> sort them by value
+	// the smallest node that is ready to be computed always comes next, so every adder graph has such an order
+	// in SCM, the last node must compute the constant -> it is not part of the order
+	bool fixed_output_node = this->C.size() == 1 and (!this->calc_twos_complement or !this->sign_inversion_allowed[this->C[0]]);
+	int last_ordered_node = fixed_output_node ? this->num_adders-1 : this->num_adders;
+	int first_ordered_node = 2;
+	if (mode == formulation_mode::add_node) {
+		// only the previously last node (SCM) or the new node (MCM) joins the order
+		first_ordered_node = std::max(2, last_ordered_node);
+	}
+	for (int idx = first_ordered_node; idx <= last_ordered_node; idx++) {
+		auto clause = this->create_less_than_literals(get_output_bits(idx-1), get_output_bits(idx), this->calc_twos_complement);
+		clause.emplace_back(this->create_uses_input_variable(idx, scm::left, idx-1));
+		clause.emplace_back(this->create_uses_input_variable(idx, scm::right, idx-1));
+		this->create_or(clause);
+	}
+}
+
+std::vector<int> scm::create_less_than_literals(const std::vector<int> &a, const std::vector<int> &b, bool is_signed) {
+	std::vector<int> less_than;
+	auto msb = (int)a.size()-1;
+	// prefix_equal implies that all bits above the current one are equal (-1 if there are none)
+	int prefix_equal = -1;
+	for (int w = msb; w >= 0; w--) {
+		// a < b if the first differing bit is 1 in b (or 1 in a for the sign bit)
+		bool a_bit_set = is_signed and w == msb;
+		auto first_difference = ++this->variable_counter;
+		this->create_new_variable(first_difference);
+		if (prefix_equal > 0) this->create_1x1_implication(first_difference, prefix_equal);
+		this->create_arbitrary_clause({{first_difference, true}, {a[w], !a_bit_set}});
+		this->create_arbitrary_clause({{first_difference, true}, {b[w], a_bit_set}});
+		less_than.emplace_back(first_difference);
+		if (w == 0) break;
+		auto equal = ++this->variable_counter;
+		this->create_new_variable(equal);
+		if (prefix_equal > 0) this->create_1x1_implication(equal, prefix_equal);
+		this->create_arbitrary_clause({{equal, true}, {a[w], true}, {b[w], false}});
+		this->create_arbitrary_clause({{equal, true}, {a[w], false}, {b[w], true}});
+		prefix_equal = equal;
+	}
+	return less_than;
+}
+
+int scm::create_uses_input_variable(int idx, input_direction dir, int input_idx) {
+	auto uses_input = ++this->variable_counter;
+	this->create_new_variable(uses_input);
+	if (idx < 2) {
+		// the first node always uses the input node
+		if (input_idx != 0) this->force_bit(uses_input, 0);
+		return uses_input;
+	}
+	auto select_word_size = this->ceil_log2(idx);
+	for (int w = 0; w < select_word_size; w++) {
+		auto bit = this->input_select_selection_variables.at({idx, dir, w});
+		if (((input_idx >> w) & 1) == 1) {
+			this->create_1x1_implication(uses_input, bit);
+		}
+		else {
+			this->create_1x1_negated_implication(uses_input, bit);
+		}
+	}
+	return uses_input;
+}
+
 int64_t scm::sign_extend(int64_t x, int w) {
 	auto sign_bit = (x >> (w-1)) & 1;
 	if (sign_bit == 0) return x; // x >= 0 -> no conversion needed
@@ -1678,6 +3233,7 @@ std::string scm::get_adder_graph_description() {
 }
 
 void scm::set_min_add(int new_min_add) {
+	this->min_add_lower_bound = new_min_add;
 	this->num_adders = std::max(this->num_adders, new_min_add-1);
 	this->num_adders = std::max(this->num_adders, 0);
 }
@@ -1690,6 +3246,111 @@ void scm::allow_node_output_shift() {
 	this->enable_node_output_shift = true;
 }
 
+void scm::solve_incrementally() {
+	this->incremental_solving = true;
+}
+
+void scm::set_parallel_adder_counts(int n) {
+	this->parallel_adder_counts = n;
+}
+
+void scm::set_cube_and_conquer(int workers, double split_after) {
+	this->cube_workers = workers;
+	this->cube_split_after = split_after;
+}
+
+void scm::use_large_neighbourhood_search(int workers, int window_size, double window_timeout) {
+	this->lns_workers = workers;
+	this->lns_window_size = std::max(1, window_size);
+	this->lns_window_timeout = window_timeout;
+}
+
+void scm::use_partitioning(int max_cluster_size, int jobs) {
+	this->max_cluster_size = max_cluster_size;
+	this->partition_jobs = std::max(1, jobs);
+}
+
+void scm::set_adder_search(adder_search strategy) {
+	this->adder_search_strategy = strategy;
+}
+
+void scm::use_restricted_domain_pass(int max_shift) {
+	this->restricted_max_shift = max_shift;
+}
+
+void scm::set_full_adder_search(full_adder_search strategy) {
+	this->full_adder_search_strategy = strategy;
+}
+
+void scm::use_heuristic_start_solution() {
+	this->use_heuristic = true;
+}
+
+void scm::use_symmetry_breaking() {
+	this->symmetry_breaking = true;
+}
+
+void scm::set_cnf_format(const cnf_writer::format &f) {
+	this->cnf_format = f;
+}
+
+void scm::set_adder_graph_table(std::shared_ptr<const adder_graph_table> table) {
+	this->graph_table = std::move(table);
+}
+
+void scm::set_result_cache(std::shared_ptr<const result_cache> cache) {
+	this->cache = std::move(cache);
+}
+
+void scm::set_time_budget(double seconds, double adder_phase_share) {
+	this->budget = time_budget(seconds, adder_phase_share);
+}
+
+void scm::set_solution_listener(std::function<void(scm &)> listener) {
+	this->solution_listener = std::move(listener);
+}
+
+void scm::report_solution() {
+	if (this->solution_listener and this->found_solution) this->solution_listener(*this);
+}
+
+void scm::report_graph(const std::vector<adder_graph_node> &graph) {
+	if (!this->solution_listener or graph.empty()) return;
+	// the listener reads the solution from this instance -> install the graph only for the report
+	auto input_select = std::move(this->input_select);
+	auto input_select_mux_output = std::move(this->input_select_mux_output);
+	auto shift_value = std::move(this->shift_value);
+	auto negate_select = std::move(this->negate_select);
+	auto subtract = std::move(this->subtract);
+	auto post_adder_shift_value = std::move(this->post_adder_shift_value);
+	auto add_result_values = std::move(this->add_result_values);
+	auto output_values = std::move(this->output_values);
+	auto num_adders = this->num_adders;
+	bool found_solution = this->found_solution;
+	bool ran_into_timeout = this->ran_into_timeout;
+	this->set_adder_graph(graph);
+	this->report_solution();
+	this->input_select = std::move(input_select);
+	this->input_select_mux_output = std::move(input_select_mux_output);
+	this->shift_value = std::move(shift_value);
+	this->negate_select = std::move(negate_select);
+	this->subtract = std::move(subtract);
+	this->post_adder_shift_value = std::move(post_adder_shift_value);
+	this->add_result_values = std::move(add_result_values);
+	this->output_values = std::move(output_values);
+	this->num_adders = num_adders;
+	this->found_solution = found_solution;
+	this->ran_into_timeout = ran_into_timeout;
+}
+
+std::pair<long int, long int> scm::get_full_adder_bounds() {
+	return {this->full_adder_lower_bound, this->full_adder_upper_bound};
+}
+
+std::pair<int, int> scm::get_adder_bounds() {
+	return {this->adder_lower_bound, this->found_solution ? this->num_adders : -1};
+}
+
 std::pair<int, int> scm::solution_is_optimal() {
 	return {this->num_add_opt, this->num_FA_opt};
 }
@@ -1719,12 +3380,12 @@ void scm::create_full_adder_coeff_word_size_constraints(int idx, formulation_mod
 		this->force_bit(carry_bit, 1);*/
 		int carry_bit = this->init_const_one_bit();
 		std::vector<int> inv_c_bits(this->word_size);
-		auto &sign_bit = this->adder_output_value_variables.at({idx, this->word_size-1});
+		auto sign_bit = this->adder_output_value_variables.at({idx, this->word_size-1});
 		for (int w = 0; w < this->word_size; w++) {
 			// first, implement c*(-1)
 			auto sum_bit = inv_c_bits[w] = ++this->variable_counter; // sum bit
 			this->create_new_variable(this->variable_counter);
-			auto &add_bit = this->adder_output_value_variables.at({idx, w});
+			auto add_bit = this->adder_output_value_variables.at({idx, w});
 			if (w < this->word_size-1) {
 				int carry_out_bit = ++this->variable_counter;
 				this->create_new_variable(this->variable_counter);
@@ -2128,6 +3789,43 @@ void scm::create_full_adder_result_constraints() {
 	}
 }
 
+void scm::create_full_adder_limit_constraints(formulation_mode mode) {
+	if (mode == formulation_mode::only_FA_limit) return;
+	// force num_full_adders <= limit (both in 2's complement)
+	auto input_word_size_add = this->ceil_log2(this->word_size * this->num_adders + 1);
+	auto input_word_size_sub = this->ceil_log2((this->num_adders + 1) * this->max_shift + 1);
+	auto output_word_size = std::max(input_word_size_add, input_word_size_sub)+1;
+	this->full_adder_limit_variables.clear();
+	this->full_adder_limit_le_variables.clear();
+	for (int w=0; w<output_word_size; w++) {
+		this->full_adder_limit_variables[w] = ++this->variable_counter;
+		this->create_new_variable(this->variable_counter);
+		this->full_adder_limit_le_variables[w] = ++this->variable_counter;
+		this->create_new_variable(this->variable_counter);
+	}
+	// le[w] -> x[w:0] <= limit[w:0]
+	// it is sufficient to encode this direction because we only force le[MSB] = 1
+	for (int w=0; w<output_word_size; w++) {
+		auto x = this->full_adder_result_variables.at(w);
+		auto l = this->full_adder_limit_variables.at(w);
+		auto le = this->full_adder_limit_le_variables.at(w);
+		if (w == output_word_size-1) {
+			// sign bit: x < 0 <= limit is fine but x >= 0 > limit is not
+			this->create_arbitrary_clause({{le, true}, {x, false}, {l, true}});
+		}
+		else {
+			// x[w] = 1 and limit[w] = 0 is not allowed
+			this->create_arbitrary_clause({{le, true}, {x, true}, {l, false}});
+		}
+		if (w == 0) continue;
+		// x[w] == limit[w] -> lower bits decide
+		auto le_last = this->full_adder_limit_le_variables.at(w-1);
+		this->create_arbitrary_clause({{le, true}, {x, false}, {l, false}, {le_last, false}});
+		this->create_arbitrary_clause({{le, true}, {x, true}, {l, true}, {le_last, false}});
+	}
+	this->force_bit(this->full_adder_limit_le_variables.at(output_word_size-1), 1);
+}
+
 void scm::create_full_adder(std::pair<int, bool> a, std::pair<int, bool> b, std::pair<int, bool> c_i, std::pair<int, bool> sum, std::pair<int, bool> c_o) {
 	//this->create_add_sum(a, b, c_i, sum);
 	// 1)
@@ -11,6 +11,19 @@
 #include <sstream>
 #include <cstdint>
 #include <limits>
+#include <string>
+#include <atomic>
+#include <mutex>
+#include <initializer_list>
+#include <memory>
+#include <functional>
+#include <adder_graph.h>
+#include <adder_graph_table.h>
+#include <result_cache.h>
+#include <variable_map.h>
+#include <cnf_writer.h>
+#include <time_budget.h>
+#include <clause_exchange.h>
 
 #define SHIFT_SELECT_OLD 0
 #define FULL_ADDERS_UNLIMITED std::numeric_limits<long int>::min()
@@ -21,7 +34,13 @@ public:
 		left, right
 	};
 	enum formulation_mode {
-		reset_all, all_FA_clauses, only_FA_limit
+		reset_all, all_FA_clauses, only_FA_limit, add_node
+	};
+	enum full_adder_search {
+		linear_FA_search, binary_FA_search, core_guided_FA_search
+	};
+	enum adder_search {
+		bottom_up_adder_search, top_down_adder_search, binary_adder_search
 	};
 	const std::set<input_direction> input_directions = {left, right};
 	/*!
@@ -31,6 +50,10 @@ public:
 	 * @param quiet true/false
 	 */
 	scm(const std::vector<int> &C, int timeout, bool quiet, int threads, bool allow_negative_numbers, bool write_cnf);
+	/*!
+	 * backends are owned through pointers to this class -> make sure that their destructors run
+	 */
+	virtual ~scm() = default;
 	/*!
 	 * define the minimum number of needed adders to help the algorithm converge faster
 	 * @param new_min_add value
@@ -51,10 +74,140 @@ public:
 	 * @param only_apply_to_negative_coefficients only allow this option for negative requested coefficients
 	 */
 	void ignore_sign(bool only_apply_to_negative_coefficients);
+	/*!
+	 * keep the backend alive when increasing the number of adders during this->solve()
+	 * instead of rebuilding the whole problem, only the variables and clauses of the new node are added
+	 * and the output constraints are activated via assumptions so that learned clauses are reused
+	 * only has an effect if the backend supports assumptions
+	 */
+	void solve_incrementally();
+	/*!
+	 * solve the problem for several adder counts at once during this->solve()
+	 * a solution for k adders cancels all attempts above k and an infeasibility proof for k adders starts the next attempt
+	 * each attempt uses a separate backend instance
+	 * @param n number of adder counts that are solved in parallel (n <= 1 disables this)
+	 */
+	void set_parallel_adder_counts(int n);
+	/*!
+	 * split each SAT call of this->solve() into cubes that are solved on a work-stealing pool
+	 * a cube fixes the input select, shift and negate bits of the first nodes via assumptions
+	 * and a cube that is not solved within its time slice is split into two cubes that get twice the time
+	 * each worker thread has its own backend instance, so this only has an effect if the backend supports assumptions
+	 * @param workers number of worker threads (workers <= 1 disables this)
+	 * @param split_after time slice in seconds for the initial cubes
+	 */
+	void set_cube_and_conquer(int workers, double split_after = 1.0);
+	/*!
+	 * replace the exact search of this->solve() by a large neighbourhood search that starts at the heuristic solution
+	 * each worker repeatedly fixes all nodes outside a random window of consecutive nodes via assumptions
+	 * and lets the backend either rebuild the window with one adder less or (if full adders are minimized) with fewer full adders
+	 * improvements are accepted immediately and the search runs until the time budget (or the timeout if there is none) runs out
+	 * the result is not proven to be optimal; this only has an effect if the backend supports assumptions
+	 * @param workers number of windows that are solved in parallel (workers <= 0 disables this)
+	 * @param window_size number of nodes that the backend may change
+	 * @param window_timeout time limit in seconds for each window (the timeout also applies)
+	 */
+	void use_large_neighbourhood_search(int workers, int window_size = 4, double window_timeout = 2.0);
+	/*!
+	 * solve large MCM problems by clustering the constants (by the subexpressions they can share)
+	 * then each cluster is solved as a separate problem with the settings of this instance, the cluster graphs are merged
+	 * and a large neighbourhood search on the merged graph finds sharing between the clusters
+	 * if a time budget is set, the clusters get half of it and the large neighbourhood search gets the rest
+	 * the result is not proven to be optimal; this only has an effect if there are more constants than fit into one cluster
+	 * @param max_cluster_size maximum number of constants per cluster (<= 0 disables this)
+	 * @param jobs number of clusters that are solved in parallel
+	 */
+	void use_partitioning(int max_cluster_size, int jobs);
+	/*!
+	 * try each adder count in a smaller problem first: the shifts are limited to max_shift
+	 * and the node values are limited to the bit width of the largest constant, i.e., to values < 2^ceil_log2(max(C)+1) (one bit less than the full word size)
+	 * only if the smaller problem has no solution (or runs into its timeout), the full problem is solved for this adder count
+	 * solutions of the smaller problem are valid and still optimal because all smaller adder counts were checked in the full problem
+	 * the smaller problem gets a quarter of the timeout
+	 * @param max_shift maximum shift in the smaller problem (<= 0 disables this)
+	 */
+	void use_restricted_domain_pass(int max_shift);
+	/*!
+	 * define how the full adder limit is chosen during this->solve() if full adders are minimized
+	 *   -> linear_FA_search: decrease the limit by 1 after each solution (default)
+	 *   -> binary_FA_search: bisect between the lower bound and the best solution
+	 *   -> core_guided_FA_search: like binary_FA_search but infeasible limits raise the lower bound as far as the UNSAT core allows
+	 * binary and core-guided search need a backend that supports assumptions to avoid rebuilding the problem for each limit
+	 * @param strategy
+	 */
+	void set_full_adder_search(full_adder_search strategy);
+	/*!
+	 * define how the adder counts are chosen during this->solve()
+	 *   -> bottom_up_adder_search: start at the lower bound and increase the adder count until a solution is found (default)
+	 *   -> top_down_adder_search: start one below the upper bound and decrease the adder count until the problem is infeasible
+	 *   -> binary_adder_search: bisect between the lower and the upper bound
+	 * the upper bound is the heuristic solution or a solution from the result cache; bottom-up search is used if there is none
+	 * top-down and binary search always rebuild the problem (incremental solving is ignored)
+	 * @param strategy
+	 */
+	void set_adder_search(adder_search strategy);
+	/*!
+	 * build an adder graph with a fast heuristic before starting the SAT search during this->solve()
+	 * it is used as solution if the SAT search reaches its adder count and it provides the initial solver phases
+	 */
+	void use_heuristic_start_solution();
+	/*!
+	 * add constraints that rule out equivalent solutions during this->solve()
+	 *   -> additions always shift the left input (the right one is never shifted)
+	 *   -> all fundamentals are distinct
+	 *   -> consecutive nodes where the second one does not use the first one are sorted by value
+	 * at least one solution of each equivalence class remains, i.e., the search stays complete
+	 */
+	void use_symmetry_breaking();
+	/*!
+	 * set the format of the CNF files (only relevant if the instance was created with write_cnf = true)
+	 * @param f
+	 */
+	void set_cnf_format(const cnf_writer::format &f);
+	/*!
+	 * look up single constants in a table of precomputed adder graphs during this->solve()
+	 * the SAT search is skipped if the table contains an optimal solution for the current settings
+	 * @param table the table (shared because it is memory-mapped only once)
+	 */
+	void set_adder_graph_table(std::shared_ptr<const adder_graph_table> table);
+	/*!
+	 * reuse and store results in a persistent cache during this->solve()
+	 * optimal cached results skip the SAT search and partial results (e.g., after timeouts) provide bounds and a start solution
+	 * @param cache the cache (it may be shared between several instances)
+	 */
+	void set_result_cache(std::shared_ptr<const result_cache> cache);
+	/*!
+	 * limit the wall-clock time of this->solve() (the timeout still limits each SAT call)
+	 * when the budget runs out, this->solve() returns the best solution found so far (if any)
+	 * @param seconds total budget (<= 0 -> unlimited)
+	 * @param adder_phase_share fraction of the budget for finding the adder count if full adders are minimized as well
+	 *   (without heuristic start solution, the adder count search may use the whole budget because there is nothing to minimize otherwise)
+	 */
+	void set_time_budget(double seconds, double adder_phase_share = 0.8);
+	/*!
+	 * call listener during this->solve() whenever the SAT search finds a better solution
+	 * (the solution of the adder count search and each solution with fewer full adders)
+	 * the listener runs in the thread that called this->solve() and can query the solution and its bounds
+	 * @param listener
+	 */
+	void set_solution_listener(std::function<void(scm &)> listener);
 	/*!
 	 * solve the problem
 	 */
 	void solve();
+	/*!
+	 * read the settings that are needed to decode a CNF file written by satscm from its variable map file
+	 * -> create the instance that calls this->solve_cnf_file with them
+	 * @param cnf_filename
+	 * @return < constants, allow negative numbers >
+	 */
+	static std::pair<std::vector<int>, bool> read_cnf_problem(const std::string &cnf_filename);
+	/*!
+	 * solve a CNF file that was written by satscm (possibly with a different backend)
+	 * and decode the solution with the variable map file that was written next to it
+	 * @param cnf_filename
+	 */
+	void solve_cnf_file(const std::string &cnf_filename);
 	/*!
 	 * print solution values
 	 */
@@ -77,6 +230,84 @@ public:
 	 *   -> pair.second: optimal w.r.t. full adder count (low level costs)
 	 */
 	std::pair<int, int> solution_is_optimal();
+	/*!
+	 * @return the full adder bounds that were proven while minimizing full adders
+	 *   -> pair.first: all solutions need at least this many full adders
+	 *   -> pair.second: full adders of the best solution
+	 */
+	std::pair<long int, long int> get_full_adder_bounds();
+	/*!
+	 * @return the adder count bounds of the current solution
+	 *   -> pair.first: all solutions need at least this many adders
+	 *   -> pair.second: adders of the best solution
+	 */
+	std::pair<int, int> get_adder_bounds();
+	/*!
+	 * @return the nodes of the current solution (node 0 is not included)
+	 */
+	std::vector<adder_graph_node> get_adder_graph();
+
+	//////////////////////////////////////////////////////////////////
+	//// solve problems that were constructed by another instance ////
+	//////////////////////////////////////////////////////////////////
+	/*!
+	 * replace the problem in the backend by a problem that was constructed elsewhere
+	 * (e.g., by scm_portfolio which distributes one problem to several backends)
+	 * @param num_variables number of variables (the first variable index is 1)
+	 * @param clauses all clauses in DIMACS format, i.e., the literals of each clause are terminated by 0
+	 */
+	void load_cnf(int num_variables, const std::vector<int> &clauses);
+	/*!
+	 * add variables and clauses to the problem that was loaded via this->load_cnf (the backend keeps what it learned)
+	 * @param num_variables number of variables including the new ones
+	 * @param clauses new clauses in DIMACS format
+	 * @param num_literals length of clauses
+	 * @return false if the problem can't be extended because the last this->solve_cnf forced its assumptions
+	 *   -> the problem must be loaded again in this case
+	 */
+	bool extend_cnf(int num_variables, const int *clauses, size_t num_literals);
+	/*!
+	 * solve the problem that was loaded via this->load_cnf
+	 * @param cnf_assumptions < variable idx, negate > literals that must hold
+	 * @param cnf_timeout in seconds
+	 * @return < whether the problem is feasible, whether we ran into a timeout >
+	 */
+	std::pair<bool, bool> solve_cnf(const std::vector<std::pair<int, bool>> &cnf_assumptions, double cnf_timeout);
+	/*!
+	 * @param var_idx
+	 * @return the value of a variable after this->solve_cnf found a solution
+	 */
+	int get_cnf_value(int var_idx);
+	/*!
+	 * @param assumption < variable idx, negate > literal that was passed to this->solve_cnf
+	 * @return whether the assumption is part of the UNSAT core after this->solve_cnf proved infeasibility
+	 */
+	bool cnf_assumption_failed(const std::pair<int, bool> &assumption);
+	/*!
+	 * suggest a value for a variable of the loaded problem (if the backend supports it)
+	 * @param var_idx
+	 * @param value
+	 */
+	void set_cnf_phase(int var_idx, bool value);
+	/*!
+	 * stop the backend as soon as possible
+	 * this is safe to call from another thread while the backend is solving
+	 * the backend then reports a timeout and this->solve() returns with the best solution found so far (if any)
+	 */
+	void interrupt();
+	/*!
+	 * use a different random seed and configuration (if the backend supports it)
+	 * this is used to diversify parallel instances that solve the same problem
+	 * @param seed
+	 */
+	void set_random_seed(int seed);
+	/*!
+	 * exchange short learned clauses with other instances that solve exactly the same problem
+	 * (e.g., the workers of the portfolio backend or of cube-and-conquer)
+	 * this must be called before the problem is constructed and only backends that support it (cadical) use it
+	 * @param exchange (nullptr -> don't share clauses)
+	 */
+	void share_learned_clauses(std::shared_ptr<clause_exchange> exchange);
 
 protected:
 	/*!
@@ -94,18 +325,55 @@ protected:
 	 * reset the solver backend
 	 */
 	virtual void reset_backend(formulation_mode mode);
+	/*!
+	 * @return whether the backend is able to solve under the assumptions in this->assumptions
+	 */
+	virtual bool supports_assumptions();
+	/*!
+	 * @param assumption < variable idx, negate > literal in this->assumptions
+	 * @return whether the assumption was needed to prove infeasibility (true if the backend can't tell)
+	 */
+	virtual bool assumption_failed(const std::pair<int, bool> &assumption);
+	/*!
+	 * suggest a value that the backend should try first for a variable (does nothing if the backend can't handle it)
+	 * @param var_idx
+	 * @param value
+	 */
+	virtual void set_preferred_phase(int var_idx, bool value);
+	/*!
+	 * stop solving as soon as possible (called from another thread)
+	 */
+	virtual void interrupt_backend();
+	/*!
+	 * @param C the constants of the new instance
+	 * @return a new instance of the same backend with the same constructor settings (used for parallel attempts and sub-problems)
+	 */
+	virtual std::unique_ptr<scm> create_instance(const std::vector<int> &C);
 
 	/*!
 	 * create new variable (if backend needs it)
 	 * @param idx variable index (=name)
 	 */
 	virtual void create_new_variable(int idx);
+	/*!
+	 * pass a clause to the backend
+	 * @param literals DIMACS literals (negative for negated variables) without the terminating 0
+	 *   -> they are only valid during this call, so the backend must copy them if it needs them later
+	 * @param num_literals
+	 */
+	virtual void add_clause_to_backend(const int *literals, int num_literals);
 	/*!
 	 * helper function to create an arbitrary clause:
 	 * @param a < variable idx, negate >
 	 *   -> negate the variable if negate == true
 	 */
-	virtual void create_arbitrary_clause(const std::vector<std::pair<int, bool>> &a);
+	void create_arbitrary_clause(std::initializer_list<std::pair<int, bool>> a);
+	/*!
+	 * create a clause from DIMACS literals (negative for negated variables) without the terminating 0
+	 * @param literals
+	 * @param num_literals
+	 */
+	void create_clause(const int *literals, int num_literals);
 
 	///////////////////////////////////////////////////
 	//// create clauses for the following circuits ////
@@ -369,6 +637,13 @@ protected:
 	 * @param num
 	 */
 	virtual void force_number(const std::vector<int> &x, int val);
+	/*!
+	 * force a -> (x == num)
+	 * @param a
+	 * @param x vector that contains all bits
+	 * @param num
+	 */
+	virtual void force_number_if(int a, const std::vector<int> &x, int val);
 
 	/*!
 	 * @param n
@@ -389,6 +664,29 @@ protected:
 	 * count #constraints
 	 */
 	int constraint_counter = 0;
+	/*!
+	 * literals that must hold during the next call to this->check()
+	 * < variable idx, negate >
+	 *   -> negate the variable if negate == true
+	 */
+	std::vector<std::pair<int, bool>> assumptions;
+	/*!
+	 * set by this->interrupt()
+	 * backends must not start solving while this is true
+	 */
+	std::atomic<bool> interrupt_requested = false;
+	/*!
+	 * whether this->solve_cnf added its assumptions as unit clauses
+	 */
+	bool cnf_assumptions_forced = false;
+	/*!
+	 * random seed for the backend (0 = backend default)
+	 */
+	int random_seed = 0;
+	/*!
+	 * learned clauses are exchanged with other instances via this (nullptr if they are not shared)
+	 */
+	std::shared_ptr<clause_exchange> learned_clause_exchange;
 
 	/*!
 	 * the constant by which we want to multiply
@@ -445,13 +743,22 @@ protected:
 	 */
 	bool num_FA_opt = false;
 	/*!
-	 * solver timeout
+	 * solver timeout (upper limit for each SAT call)
 	 */
 	int timeout;
 	/*!
-	 * timeout for FA minimization (duh!)
+	 * time limit in seconds for the current call of this->check()
+	 * backends must use this instead of this->timeout because it also respects this->budget
 	 */
-	int fa_minimization_timeout;
+	double check_timeout;
+	/*!
+	 * total wall-clock budget and the deadlines of the current phase of this->solve()
+	 */
+	time_budget budget;
+	/*!
+	 * called for each improved solution (see set_solution_listener)
+	 */
+	std::function<void(scm &)> solution_listener;
 	/*!
 	 * suppress debug outputs if quiet = true
 	 */
@@ -478,6 +785,105 @@ protected:
 	 * whether we also allow a shift at each node's output
 	 */
 	bool enable_node_output_shift = false;
+	/*!
+	 * whether we add nodes to the existing problem instead of rebuilding it when increasing the number of adders
+	 */
+	bool incremental_solving = false;
+	/*!
+	 * number of adder counts that are solved in parallel
+	 */
+	int parallel_adder_counts = 1;
+	/*!
+	 * number of threads that solve cubes (<= 1 -> no cube-and-conquer)
+	 */
+	int cube_workers = 1;
+	/*!
+	 * time slice of the initial cubes in seconds
+	 */
+	double cube_split_after = 1.0;
+	/*!
+	 * number of large neighbourhood search workers (<= 0 -> exact search)
+	 */
+	int lns_workers = 0;
+	/*!
+	 * number of nodes that may change in each large neighbourhood search step
+	 */
+	int lns_window_size = 4;
+	/*!
+	 * time limit in seconds for each large neighbourhood search step
+	 */
+	double lns_window_timeout = 2.0;
+	/*!
+	 * maximum number of constants per cluster (<= 0 -> no partitioning)
+	 */
+	int max_cluster_size = 0;
+	/*!
+	 * number of clusters that are solved in parallel
+	 */
+	int partition_jobs = 1;
+	/*!
+	 * maximum shift in the restricted domain pass (<= 0 -> no restricted domain pass)
+	 */
+	int restricted_max_shift = 0;
+	/*!
+	 * how the full adder limit is chosen
+	 */
+	full_adder_search full_adder_search_strategy = full_adder_search::linear_FA_search;
+	/*!
+	 * how the adder counts are chosen
+	 */
+	adder_search adder_search_strategy = adder_search::bottom_up_adder_search;
+	/*!
+	 * whether we start with a heuristic solution
+	 */
+	bool use_heuristic = false;
+	/*!
+	 * whether symmetry breaking constraints are added
+	 */
+	bool symmetry_breaking = false;
+	/*!
+	 * format of the cnf files
+	 */
+	cnf_writer::format cnf_format;
+	/*!
+	 * the heuristic solution (empty if there is none)
+	 */
+	std::vector<adder_graph_node> heuristic_graph;
+	/*!
+	 * precomputed adder graphs (nullptr if there are none)
+	 */
+	std::shared_ptr<const adder_graph_table> graph_table;
+	/*!
+	 * persistent result cache (nullptr if there is none)
+	 */
+	std::shared_ptr<const result_cache> cache;
+	/*!
+	 * all solutions need at least this many adders
+	 */
+	int adder_lower_bound = 0;
+	/*!
+	 * number of unique constants (the lower bound that holds without any proof)
+	 */
+	int trivial_adder_lower_bound = 0;
+	/*!
+	 * lower bound that was set via this->set_min_add (it is not proven -> it must not end up in the cache)
+	 */
+	int min_add_lower_bound = 0;
+	/*!
+	 * lower bound for the number of full adders from the cache
+	 * it is only valid for cached_num_adders adders
+	 */
+	int cached_num_adders = -1;
+	long int cached_full_adder_lower_bound = FULL_ADDERS_UNLIMITED;
+	/*!
+	 * proven bounds for the number of full adders
+	 */
+	long int full_adder_lower_bound = FULL_ADDERS_UNLIMITED;
+	long int full_adder_upper_bound = FULL_ADDERS_UNLIMITED;
+	/*!
+	 * the constants as they were passed to the constructor
+	 */
+	std::vector<int> original_C;
 
 private:
 	/*!
@@ -486,13 +892,68 @@ private:
 	 */
 	long int max_full_adders = FULL_ADDERS_UNLIMITED;
 	/*!
-	 * store all cnf clauses for cnf file generation
+	 * streams all cnf clauses to disk for cnf file generation (nullptr if no cnf files are written)
+	 */
+	std::unique_ptr<cnf_writer> cnf;
+	/*!
+	 * reused for building clauses so that creating a clause does not allocate memory
 	 */
-	std::stringstream cnf_clauses;
+	std::vector<int> clause_buffer;
 	/*!
 	 * creates a .cnf file for the current SAT problem
+	 * and a .map file with everything needed to decode a solution of it (see this->solve_cnf_file)
 	 */
 	void create_cnf_file();
+	/*!
+	 * @return the name of the variable map file that belongs to a CNF file
+	 */
+	static std::string get_variable_map_filename(const std::string &cnf_filename);
+	/*!
+	 * write the settings and all variable indices of the current problem
+	 */
+	void write_variable_map(const std::string &filename);
+	/*!
+	 * restore the settings and variable indices written by this->write_variable_map
+	 */
+	void read_variable_map(const std::string &filename);
+	/*!
+	 * call f(name, variable map) for all variable maps below
+	 */
+	template <typename F>
+	void for_each_variable_map(F f) {
+		f("input_select_mux_variables", this->input_select_mux_variables);
+		f("input_select_mux_output_variables", this->input_select_mux_output_variables);
+		f("input_select_selection_variables", this->input_select_selection_variables);
+		f("input_shift_value_variables", this->input_shift_value_variables);
+		f("shift_internal_mux_output_variables", this->shift_internal_mux_output_variables);
+		f("shift_output_variables", this->shift_output_variables);
+		f("input_negate_select_variables", this->input_negate_select_variables);
+		f("negate_select_output_variables", this->negate_select_output_variables);
+		f("input_negate_value_variables", this->input_negate_value_variables);
+		f("xor_output_variables", this->xor_output_variables);
+		f("adder_carry_variables", this->adder_carry_variables);
+		f("adder_XOR_internal_variables", this->adder_XOR_internal_variables);
+		f("adder_output_value_variables", this->adder_output_value_variables);
+		f("input_post_adder_shift_value_variables", this->input_post_adder_shift_value_variables);
+		f("post_adder_shift_internal_mux_output_variables", this->post_adder_shift_internal_mux_output_variables);
+		f("post_adder_shift_output_variables", this->post_adder_shift_output_variables);
+		f("output_value_variables", this->output_value_variables);
+		f("full_adder_coeff_word_size_variables", this->full_adder_coeff_word_size_variables);
+		f("full_adder_coeff_word_size_internal_variables", this->full_adder_coeff_word_size_internal_variables);
+		f("full_adder_coeff_word_size_internal_carry_input_variables", this->full_adder_coeff_word_size_internal_carry_input_variables);
+		f("full_adder_msb_variables", this->full_adder_msb_variables);
+		f("full_adder_word_size_sum_variables", this->full_adder_word_size_sum_variables);
+		f("full_adder_shift_gain_variables", this->full_adder_shift_gain_variables);
+		f("full_adder_shift_sum_variables", this->full_adder_shift_sum_variables);
+		f("full_adder_msb_sum_variables", this->full_adder_msb_sum_variables);
+		f("full_adder_add_subtract_inputs_variables", this->full_adder_add_subtract_inputs_variables);
+		f("full_adder_cpa_internal_variables", this->full_adder_cpa_internal_variables);
+		f("full_adder_result_variables", this->full_adder_result_variables);
+		f("full_adder_comparator_ok_variables", this->full_adder_comparator_ok_variables);
+		f("full_adder_comparator_carry_variables", this->full_adder_comparator_carry_variables);
+		f("full_adder_limit_variables", this->full_adder_limit_variables);
+		f("full_adder_limit_le_variables", this->full_adder_limit_le_variables);
+	}
 	/*!
 	 * get solution from backend and store result in containers below
 	 */
@@ -558,10 +1019,14 @@ private:
 	 *  int value
 	 */
 	int num_FAs_value;
+	/*!
+	 * fill this->assumptions for the next call to this->check()
+	 */
+	void collect_assumptions();
 	/*!
 	 * create backend solver variables and keep track of their indices
 	 */
-	void create_variables();
+	void create_variables(formulation_mode mode);
 	/*!
 	 * create solver constraints
 	 */
@@ -574,6 +1039,129 @@ private:
 	 * optimize #adders or #full_adders within this loop
 	 */
 	void optimization_loop(formulation_mode mode);
+	/*!
+	 * minimize #adders by solving this->parallel_adder_counts adder counts at once in separate instances
+	 * the best solution is copied into this instance
+	 */
+	void parallel_adder_count_search();
+	/*!
+	 * @return the variables that define the cubes in the order in which they are split
+	 *   (input select, shift and negate bits node by node)
+	 */
+	std::vector<int> get_cube_variables();
+	/*!
+	 * solve the problem for the current adder count and full adder limit with this->cube_workers separate instances
+	 * that work on cubes of the problem; the solution is copied into this instance
+	 * @return < whether the problem is feasible, whether we ran into a timeout >
+	 */
+	std::pair<bool, bool> cube_and_conquer();
+	/*!
+	 * improve the heuristic solution with this->lns_workers separate instances that re-optimize windows of it
+	 * the best solution is copied into this instance and passed to this->solution_listener for each improvement
+	 */
+	void large_neighbourhood_search();
+	/*!
+	 * @return clusters of at most this->max_cluster_size constants (with their requested signs)
+	 *   that share many fundamentals in their heuristic adder graphs
+	 */
+	std::vector<std::vector<int>> partition_constants();
+	/*!
+	 * solve the clusters of this->partition_constants() separately, merge their graphs
+	 * and improve the merged graph with this->large_neighbourhood_search()
+	 */
+	void partition_and_merge();
+	/*!
+	 * search the adder count between this->adder_lower_bound and the size of this->heuristic_graph
+	 * according to this->adder_search_strategy (more adders never make a problem infeasible)
+	 * the best solution is copied into this instance and passed to this->solution_listener for each improvement
+	 * @return whether the backend contains the problem for the solution
+	 */
+	bool bounded_adder_search();
+	/*!
+	 * limit the domain of this instance for the restricted domain pass
+	 * must be called before a problem is constructed
+	 * @param max_shift
+	 */
+	void restrict_domain(int max_shift);
+	/*!
+	 * solve the problem for this->num_adders in this->restricted_instance
+	 * @return whether a solution was found (it is copied into this instance)
+	 */
+	bool solve_in_restricted_domain();
+	/*!
+	 * instance for the restricted domain pass (only exists during this->solve())
+	 */
+	std::unique_ptr<scm> restricted_instance;
+	/*!
+	 * guards this->restricted_instance against this->interrupt()
+	 */
+	std::mutex restricted_instance_mutex;
+	/*!
+	 * formulation mode for the next call of the restricted instance
+	 */
+	formulation_mode restricted_mode = formulation_mode::reset_all;
+	/*!
+	 * @param idx node index in the problem of this instance
+	 * @param node the values that the node should have
+	 * @param fix_left_input whether the left input select is fixed as well
+	 * @param fix_right_input whether the right input select is fixed as well
+	 * @return < variable idx, negate > literals that fix the structure of the node (inputs, shift, negation and output shift)
+	 */
+	std::vector<std::pair<int, bool>> get_node_assumptions(int idx, const adder_graph_node &node, bool fix_left_input, bool fix_right_input);
+	/*!
+	 * use the given adder graph as solution
+	 */
+	void set_adder_graph(const std::vector<adder_graph_node> &graph);
+	/*!
+	 * set the preferred phases of the node variables to the values of the best known solution
+	 * (only for the new node in add_node mode and for all nodes otherwise)
+	 */
+	void seed_phases(formulation_mode mode);
+	/*!
+	 * look up the constant in this->graph_table
+	 * @return whether the table contained an optimal solution that is now the current solution
+	 */
+	bool solve_from_table();
+	/*!
+	 * @return the cache key for the normalized constants and all options that influence the result
+	 */
+	std::string get_cache_key();
+	/*!
+	 * look up the problem in this->cache and use its bounds and solution
+	 * @return whether the cached solution is optimal for the current settings and is now the current solution
+	 */
+	bool solve_from_cache();
+	/*!
+	 * merge the current solution and bounds into this->cache
+	 */
+	void store_in_cache();
+	/*!
+	 * pass the current solution to this->solution_listener (if there is one)
+	 */
+	void report_solution();
+	/*!
+	 * pass a graph that is better than everything reported so far to this->solution_listener
+	 * without replacing the solution and the adder count of the running search
+	 * @param graph
+	 */
+	void report_graph(const std::vector<adder_graph_node> &graph);
+	/*!
+	 * @return the number of full adders of the current solution
+	 */
+	int count_full_adders();
+	/*!
+	 * should be called after the backend proved that this->max_full_adders is infeasible
+	 * @return the largest limit that is infeasible according to the UNSAT core
+	 */
+	long int get_infeasible_full_adder_limit();
+	/*!
+	 * pass all settings that affect the problem formulation to another instance
+	 */
+	void copy_settings_to(scm &other) const;
+	/*!
+	 * take over the solution that was found by another instance
+	 */
+	void copy_solution_from(const scm &other);
 	/*!
 	 * cache values for ceil(log2(n))
 	 */
@@ -617,6 +1205,16 @@ private:
 	void create_post_adder_shift_constraints(int idx, formulation_mode mode);
 	void create_odd_fundamentals_constraints(int idx, formulation_mode mode);
 	void create_mcm_output_constraints(formulation_mode mode);
+	void create_symmetry_breaking_constraints(formulation_mode mode);
+	/*!
+	 * @return literals where each one implies a < b (a and b are given LSB first)
+	 *   -> at least one of them can be true if and only if a < b
+	 */
+	std::vector<int> create_less_than_literals(const std::vector<int> &a, const std::vector<int> &b, bool is_signed);
+	/*!
+	 * @return a variable that can only be true if the node with index idx uses the node with index input_idx as left or right input
+	 */
+	int create_uses_input_variable(int idx, input_direction dir, int input_idx);
 	void create_full_adder_coeff_word_size_constraints(int idx, formulation_mode mode);
 	void create_full_adder_msb_constraints(int idx, formulation_mode mode);
 	void create_full_adder_coeff_word_size_sum_constraints(int idx, formulation_mode mode);
@@ -626,6 +1224,11 @@ private:
 	void create_full_adder_add_subtract_inputs_constraints(formulation_mode mode);
 	void create_full_adder_cpa_constraints(formulation_mode mode);
 	void create_full_adder_result_constraints();
+	/*!
+	 * force num_full_adders <= limit where the limit bits are variables that are fixed via assumptions
+	 * the comparator is only built once and the limit can be changed arbitrarily without adding clauses
+	 */
+	void create_full_adder_limit_constraints(formulation_mode mode);
 
 	// helper function to create a bitheap in SAT ...
 	std::vector<int> create_bitheap(const std::vector<std::pair<std::vector<int>, bool>> &x);
@@ -643,76 +1246,76 @@ private:
 	/*!
 	 * < node idx, left/right, mux idx, bit > -> variable idx
 	 */
-	std::map<std::tuple<int, input_direction, int, int>, int> input_select_mux_variables;
+	variable_map<std::tuple<int, input_direction, int, int>> input_select_mux_variables;
 	/*!
 	 * < node idx, left/right, bit > -> variable idx
 	 */
-	std::map<std::tuple<int, input_direction, int>, int> input_select_mux_output_variables;
+	variable_map<std::tuple<int, input_direction, int>> input_select_mux_output_variables;
 	/*!
 	 * < node idx, left/right, bit > -> variable idx
 	 */
-	std::map<std::tuple<int, input_direction, int>, int> input_select_selection_variables;
+	variable_map<std::tuple<int, input_direction, int>> input_select_selection_variables;
 	/*!
 	 * < node idx, bit > -> variable idx
 	 */
-	std::map<std::pair<int, int>, int> input_shift_value_variables;
+	variable_map<std::pair<int, int>> input_shift_value_variables;
 	/*!
 	 * < node idx, mux stage, bit > -> variable idx
 	 */
-	std::map<std::tuple<int, int, int>, int> shift_internal_mux_output_variables;
+	variable_map<std::tuple<int, int, int>> shift_internal_mux_output_variables;
 	/*!
 	 * < node idx, bit > -> variable idx
 	 * !!! identical to the last MUX stage of shift_internal_mux_output_variables
 	 */
-	std::map<std::pair<int, int>, int> shift_output_variables;
+	variable_map<std::pair<int, int>> shift_output_variables;
 	/*!
 	 * node idx -> variable idx
 	 */
-	std::map<int, int> input_negate_select_variables;
+	variable_map<int> input_negate_select_variables;
 	/*!
 	 * < node idx, left/right, bit > -> variable idx
 	 */
-	std::map<std::tuple<int, input_direction, int>, int> negate_select_output_variables;
+	variable_map<std::tuple<int, input_direction, int>> negate_select_output_variables;
 	/*!
 	 * node idx -> variable idx
 	 */
-	std::map<int, int> input_negate_value_variables;
+	variable_map<int> input_negate_value_variables;
 	/*!
 	 * < node idx, bit > -> variable idx
 	 */
-	std::map<std::pair<int, int>, int> xor_output_variables;
+	variable_map<std::pair<int, int>> xor_output_variables;
 	/*!
 	 * < node idx, bit > -> variable idx
 	 */
-	std::map<std::pair<int, int>, int> adder_carry_variables;
+	variable_map<std::pair<int, int>> adder_carry_variables;
 	/*!
 	 * < node idx, bit > -> variable idx
 	 * used for optimized adder clauses
 	 */
-	std::map<std::pair<int, int>, int> adder_XOR_internal_variables;
+	variable_map<std::pair<int, int>> adder_XOR_internal_variables;
 	/*!
 	 * < node idx, bit > -> variable idx
 	 * !!! node idx = 0 is the input node with constant value 0
 	 */
-	std::map<std::pair<int, int>, int> adder_output_value_variables;
+	variable_map<std::pair<int, int>> adder_output_value_variables;
 	/*!
 	 * < node idx, bit > -> variable idx
 	 */
-	std::map<std::pair<int, int>, int> input_post_adder_shift_value_variables;
+	variable_map<std::pair<int, int>> input_post_adder_shift_value_variables;
 	/*!
 	 * < node idx, mux stage, bit > -> variable idx
 	 */
-	std::map<std::tuple<int, int, int>, int> post_adder_shift_internal_mux_output_variables;
+	variable_map<std::tuple<int, int, int>> post_adder_shift_internal_mux_output_variables;
 	/*!
 	 * < node idx, bit > -> variable idx
 	 * !!! identical to the last MUX stage of shift_internal_mux_output_variables
 	 */
-	std::map<std::pair<int, int>, int> post_adder_shift_output_variables;
+	variable_map<std::pair<int, int>> post_adder_shift_output_variables;
 	/*!
 	 * < node idx, bit > -> variable idx
 	 * !!! node idx = 0 is the input node with constant value 0
 	 */
-	std::map<std::pair<int, int>, int> output_value_variables;
+	variable_map<std::pair<int, int>> output_value_variables;
 	/*!
 	 * < node idx, mcm constant > -> variable idx
 	 */
@@ -720,55 +1323,69 @@ private:
 	/*!
 	 * < node idx, bit > -> variable idx
 	 */
-	std::map<std::tuple<int, int>, int> full_adder_coeff_word_size_variables;
+	variable_map<std::tuple<int, int>> full_adder_coeff_word_size_variables;
 	/*!
 	 * < idx, stage, bit > -> variable idx
 	 */
-	std::map<std::tuple<int, int, int>, int> full_adder_coeff_word_size_internal_variables;
+	variable_map<std::tuple<int, int, int>> full_adder_coeff_word_size_internal_variables;
 	/*!
 	 * < idx, stage, bit > -> variable idx
 	 */
-	std::map<std::tuple<int, int>, int> full_adder_coeff_word_size_internal_carry_input_variables;
+	variable_map<std::tuple<int, int>> full_adder_coeff_word_size_internal_carry_input_variables;
 	/*!
 	 * < node idx > -> variable idx
 	 */
-	std::map<int, int> full_adder_msb_variables;
+	variable_map<int> full_adder_msb_variables;
 	/*!
 	 * < idx, bit > -> variable idx
 	 */
-	std::map<std::tuple<int, int>, int> full_adder_word_size_sum_variables;
+	variable_map<std::tuple<int, int>> full_adder_word_size_sum_variables;
 	/*!
 	 * < idx, bit > -> variable idx
 	 */
-	std::map<std::tuple<int, int>, int> full_adder_shift_gain_variables;
+	variable_map<std::tuple<int, int>> full_adder_shift_gain_variables;
 	/*!
 	 * < idx, bit > -> variable idx
 	 */
-	std::map<std::tuple<int, int>, int> full_adder_shift_sum_variables;
+	variable_map<std::tuple<int, int>> full_adder_shift_sum_variables;
 	/*!
 	 * < bit > -> variable idx
 	 */
-	std::map<int, int> full_adder_msb_sum_variables;
+	variable_map<int> full_adder_msb_sum_variables;
 	/*!
 	 * < bit > -> variable idx
 	 */
-	std::map<int, int> full_adder_add_subtract_inputs_variables;
+	variable_map<int> full_adder_add_subtract_inputs_variables;
 	/*!
 	 * < bit > -> variable idx
 	 */
-	std::map<int, int> full_adder_cpa_internal_variables;
+	variable_map<int> full_adder_cpa_internal_variables;
 	/*!
 	 * < bit > -> variable idx
 	 */
-	std::map<int, int> full_adder_result_variables;
+	variable_map<int> full_adder_result_variables;
 	/*!
 	 * < bit > -> variable idx
 	 */
-	std::map<int, int> full_adder_comparator_ok_variables;
+	variable_map<int> full_adder_comparator_ok_variables;
 	/*!
 	 * < bit > -> variable idx
 	 */
-	std::map<int, int> full_adder_comparator_carry_variables;
+	variable_map<int> full_adder_comparator_carry_variables;
+	/*!
+	 * < bit > -> variable idx
+	 * bits of the full adder limit (2's complement) that are set via assumptions
+	 */
+	variable_map<int> full_adder_limit_variables;
+	/*!
+	 * < bit > -> variable idx
+	 * whether num_full_adders <= limit holds for the bits [0, bit]
+	 */
+	variable_map<int> full_adder_limit_le_variables;
+	/*!
+	 * activates the output constraints for the current number of adders in incremental mode
+	 */
+	int output_activation_variable = -1;
 	/*!
 	 * a variable that is forced to 1
 	 */
@@ -8,6 +8,13 @@
 
 #include <iostream>
 
+// pause the solver to import clauses of other instances if at least this many are waiting
+#define CADICAL_IMPORT_MIN_CLAUSES 64
+// ... but not more often than every x seconds (each pause restarts the search)
+#define CADICAL_IMPORT_INTERVAL 0.5
+// import at most this many clauses at once (the newest ones) so that a slow instance is not swamped
+#define CADICAL_IMPORT_MAX_CLAUSES 4096
+
 scm_cadical::scm_cadical(const std::vector<int> &C, int timeout, bool quiet, bool allow_negative_numbers, bool write_cnf)
 	: scm(C, timeout, quiet, 1, allow_negative_numbers, write_cnf) {}
 
@@ -16,40 +23,118 @@ void scm_cadical::reset_backend(formulation_mode mode) {
 	if (mode != formulation_mode::reset_all) return;
 	// create new solver
 	this->solver = std::make_unique<CaDiCaL::Solver>();
+	if (this->random_seed != 0) {
+		// diversify parallel instances
+		const char* configurations[] = {"default", "sat", "unsat"};
+		this->solver->configure(configurations[this->random_seed % 3]);
+		this->solver->set("seed", this->random_seed);
+	}
 	// create and attach new terminator
-	this->terminator = cadical_terminator(this->timeout);
+	this->terminator = cadical_terminator(this->check_timeout, &this->interrupt_requested);
 	this->solver->connect_terminator(&this->terminator);
+	// share learned clauses with the other instances that solve the same problem
+	this->exporter.reset();
+	if (this->learned_clause_exchange != nullptr) {
+		this->exchange_participant = this->learned_clause_exchange->join();
+		this->import_position = 0;
+		this->exporter = std::make_unique<cadical_clause_exporter>(this->learned_clause_exchange, this->exchange_participant);
+		this->num_exported_at_import = 0;
+		this->solver->connect_learner(this->exporter.get());
+		this->terminator.set_pause_condition([this]() { return this->import_pending(); });
+	}
 }
 
 std::pair<bool, bool> scm_cadical::check() {
-	auto stat = this->solver->solve();
+	if (this->interrupt_requested) return {false, true};
+	// the timeout applies to each call separately (the solver might be reused in incremental mode)
+	this->terminator.reset(this->check_timeout);
+	int stat;
+	do {
+		// CaDiCaL can only take new clauses between two calls to solve
+		// -> the terminator pauses the search when other instances learned enough clauses
+		this->terminator.resume();
+		if (this->exporter != nullptr) this->import_shared_clauses();
+		for (auto &it : this->assumptions) {
+			this->solver->assume(it.second?-it.first:it.first);
+		}
+		stat = this->solver->solve();
+	} while (stat != CADICAL_SAT and stat != CADICAL_UNSAT and this->terminator.paused());
 	auto sat = stat == CADICAL_SAT;
 	auto unsat = stat == CADICAL_UNSAT;
 	auto to = !sat and !unsat;
 	return {sat, to};
 }
 
+bool scm_cadical::supports_assumptions() {
+	return true;
+}
+
+bool scm_cadical::assumption_failed(const std::pair<int, bool> &assumption) {
+	return this->solver->failed(assumption.second?-assumption.first:assumption.first);
+}
+
+void scm_cadical::interrupt_backend() {
+	// nothing to do here because the terminator regularly checks this->interrupt_requested
+}
+
+std::unique_ptr<scm> scm_cadical::create_instance(const std::vector<int> &C) {
+	return std::make_unique<scm_cadical>(C, this->timeout, this->quiet, this->calc_twos_complement, this->write_cnf);
+}
+
+void scm_cadical::set_preferred_phase(int var_idx, bool value) {
+	this->solver->phase(value?var_idx:-var_idx);
+}
+
+void scm_cadical::import_shared_clauses() {
+	std::vector<int> clauses;
+	this->learned_clause_exchange->import_clauses(this->exchange_participant, this->import_position, clauses, CADICAL_IMPORT_MAX_CLAUSES);
+	for (auto &lit : clauses) {
+		this->solver->add(lit);
+	}
+	this->num_exported_at_import = this->exporter->get_num_exported();
+	this->last_import = std::chrono::steady_clock::now();
+}
+
+bool scm_cadical::import_pending() const {
+	if (std::chrono::duration<double>(std::chrono::steady_clock::now() - this->last_import).count() < CADICAL_IMPORT_INTERVAL) return false;
+	// our own clauses since the last import are pending as well
+	auto num_own = this->exporter->get_num_exported() - this->num_exported_at_import;
+	return this->learned_clause_exchange->num_pending(this->import_position) >= num_own + CADICAL_IMPORT_MIN_CLAUSES;
+}
+
 int scm_cadical::get_result_value(int var_idx) {
 	return this->solver->val(var_idx) > 0 ? 1 : 0;
 }
 
-void scm_cadical::create_arbitrary_clause(const std::vector<std::pair<int, bool>> &a) {
-	scm::create_arbitrary_clause(a);
-	for (auto &it : a) {
-		if (it.second) {
-			this->solver->add(-it.first);
-		}
-		else {
-			this->solver->add(it.first);
-		}
+void scm_cadical::add_clause_to_backend(const int *literals, int num_literals) {
+	for (int i = 0; i < num_literals; i++) {
+		this->solver->add(literals[i]);
 	}
 	this->solver->add(0);
 }
 
-cadical_terminator::cadical_terminator(double timeout) : max_time(timeout), timer_start(std::chrono::steady_clock::now()) {}
+cadical_terminator::cadical_terminator(double timeout, const std::atomic<bool> *interrupt_requested) : max_time(timeout), timer_start(std::chrono::steady_clock::now()), interrupt_requested(interrupt_requested) {}
 
 bool cadical_terminator::terminate() {
-	return this->get_elapsed_time() >= this->max_time;
+	if (this->interrupt_requested != nullptr and *this->interrupt_requested) return true;
+	if (this->get_elapsed_time() >= this->max_time) return true;
+	if (this->pause_requested != nullptr and this->pause_requested()) {
+		this->pause_flag = true;
+		return true;
+	}
+	return false;
+}
+
+void cadical_terminator::set_pause_condition(std::function<bool()> pause_requested) {
+	this->pause_requested = std::move(pause_requested);
+}
+
+bool cadical_terminator::paused() const {
+	return this->pause_flag;
+}
+
+void cadical_terminator::resume() {
+	this->pause_flag = false;
 }
 
 void cadical_terminator::reset(double new_timeout) {
@@ -61,4 +146,25 @@ double cadical_terminator::get_elapsed_time() const {
 	return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - this->timer_start).count() / 1000.0;
 }
 
+cadical_clause_exporter::cadical_clause_exporter(std::shared_ptr<clause_exchange> exchange, int participant) : exchange(std::move(exchange)), participant(participant) {}
+
+bool cadical_clause_exporter::learning(int size) {
+	// CaDiCaL doesn't tell us the LBD -> short clauses are the useful ones (units and binaries in particular)
+	return size <= this->exchange->get_max_clause_size();
+}
+
+void cadical_clause_exporter::learn(int lit) {
+	if (lit != 0) {
+		this->clause.emplace_back(lit);
+		return;
+	}
+	this->exchange->export_clause(this->participant, this->clause.data(), (int)this->clause.size());
+	this->clause.clear();
+	this->num_exported++;
+}
+
+uint64_t cadical_clause_exporter::get_num_exported() const {
+	return this->num_exported;
+}
+
 #endif //USE_CADICAL
\ No newline at end of file
@@ -11,17 +11,55 @@
 #include <cadical.hpp>
 #include <chrono>
 #include <memory>
+#include <atomic>
+#include <functional>
 #include <utility>
+#include <vector>
 
 class cadical_terminator : public CaDiCaL::Terminator {
 public:
-	explicit cadical_terminator(double timeout = 0.0);
+	explicit cadical_terminator(double timeout = 0.0, const std::atomic<bool> *interrupt_requested = nullptr);
 	bool terminate () override;
 	void reset(double newTimeout);
 	double get_elapsed_time() const;
+	/*!
+	 * also stop the solver (without resetting the timer) whenever pause_requested returns true
+	 * @param pause_requested (nullptr -> never pause)
+	 */
+	void set_pause_condition(std::function<bool()> pause_requested);
+	/*!
+	 * @return whether the solver was stopped because of the pause condition (and not because of a timeout or an interrupt)
+	 */
+	bool paused() const;
+	/*!
+	 * clear the pause flag before solving again
+	 */
+	void resume();
 private:
 	double max_time;
 	std::chrono::steady_clock::time_point timer_start;
+	const std::atomic<bool> *interrupt_requested;
+	std::function<bool()> pause_requested;
+	bool pause_flag = false;
+};
+
+/*!
+ * passes the short clauses that CaDiCaL learns to a clause_exchange
+ */
+class cadical_clause_exporter : public CaDiCaL::Learner {
+public:
+	cadical_clause_exporter(std::shared_ptr<clause_exchange> exchange, int participant);
+	bool learning(int size) override;
+	void learn(int lit) override;
+	/*!
+	 * @return the number of exported clauses
+	 */
+	uint64_t get_num_exported() const;
+private:
+	std::shared_ptr<clause_exchange> exchange;
+	int participant;
+	std::vector<int> clause;
+	uint64_t num_exported = 0;
 };
 
 class scm_cadical : public scm {
@@ -36,12 +74,36 @@ protected:
 	std::pair<bool, bool> check() override;
 	void reset_backend(formulation_mode mode) override;
 	int get_result_value(int var_idx) override;
+	bool supports_assumptions() override;
+	bool assumption_failed(const std::pair<int, bool> &assumption) override;
+	void interrupt_backend() override;
+	std::unique_ptr<scm> create_instance(const std::vector<int> &C) override;
+	void set_preferred_phase(int var_idx, bool value) override;
 
-	void create_arbitrary_clause(const std::vector<std::pair<int, bool>> &a) override;
+	void add_clause_to_backend(const int *literals, int num_literals) override;
 
 private:
 	std::unique_ptr<CaDiCaL::Solver> solver;
 	cadical_terminator terminator;
+	/*!
+	 * only used if this->learned_clause_exchange is set
+	 */
+	std::unique_ptr<cadical_clause_exporter> exporter;
+	int exchange_participant = -1;
+	uint64_t import_position = 0;
+	/*!
+	 * number of exported clauses at the last import (they are pending in the exchange but we don't import them)
+	 */
+	uint64_t num_exported_at_import = 0;
+	std::chrono::steady_clock::time_point last_import;
+	/*!
+	 * add the clauses that other instances learned since the last call
+	 */
+	void import_shared_clauses();
+	/*!
+	 * @return whether enough clauses of other instances are waiting to pause the solver and import them
+	 */
+	bool import_pending() const;
 };
 
 #endif //USE_CADICAL
@@ -0,0 +1,249 @@
+//
+// Created by nfiege on 11/24/22.
+//
+
+#include "scm_external.h"
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <chrono>
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <mutex>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+scm_external::scm_external(const std::vector<int> &C, int timeout, bool quiet, bool allow_negative_numbers, bool write_cnf, const std::string &command, long memory_limit)
+	: scm(C, timeout, quiet, 1, allow_negative_numbers, write_cnf), command(command), memory_limit(memory_limit) {
+	std::stringstream s(command);
+	std::string arg;
+	while (s >> arg) {
+		this->arguments.emplace_back(arg);
+	}
+	if (this->arguments.empty()) throw std::runtime_error("no executable given for the external solver");
+	// a solver that exits before reading all clauses must not kill us when we write to its stdin
+	static std::once_flag ignore_sigpipe;
+	std::call_once(ignore_sigpipe, []() { signal(SIGPIPE, SIG_IGN); });
+}
+
+void scm_external::reset_backend(formulation_mode mode) {
+	scm::reset_backend(mode);
+	if (mode != formulation_mode::reset_all) return;
+	this->clauses.clear();
+	this->num_clauses = 0;
+	this->model.clear();
+}
+
+std::pair<bool, bool> scm_external::check() {
+	if (this->interrupt_requested) return {false, true};
+	// the solver process only lives for this call -> the assumptions are simply added as unit clauses
+	std::vector<int> unit_literals;
+	for (auto &it : this->assumptions) {
+		unit_literals.emplace_back(it.second?-it.first:it.first);
+	}
+	// prepare everything for the child process before forking
+	std::vector<char*> argv;
+	for (auto &arg : this->arguments) {
+		argv.emplace_back(const_cast<char*>(arg.c_str()));
+	}
+	argv.emplace_back(nullptr);
+	int to_solver[2];
+	int from_solver[2];
+	// O_CLOEXEC -> solvers started by other threads don't inherit our pipes
+	if (pipe2(to_solver, O_CLOEXEC) != 0) throw std::runtime_error(std::string("failed to create pipe: ")+std::strerror(errno));
+	if (pipe2(from_solver, O_CLOEXEC) != 0) {
+		close(to_solver[0]);
+		close(to_solver[1]);
+		throw std::runtime_error(std::string("failed to create pipe: ")+std::strerror(errno));
+	}
+	int dev_null = this->quiet ? open("/dev/null", O_WRONLY | O_CLOEXEC) : -1;
+	auto pid = fork();
+	if (pid == 0) {
+		// child: own process group so that we can also terminate processes started by the solver
+		setpgid(0, 0);
+		dup2(to_solver[0], STDIN_FILENO);
+		dup2(from_solver[1], STDOUT_FILENO);
+		if (dev_null >= 0) dup2(dev_null, STDERR_FILENO);
+		if (this->memory_limit > 0) {
+			struct rlimit limit;
+			limit.rlim_cur = limit.rlim_max = (rlim_t)this->memory_limit << 20;
+			setrlimit(RLIMIT_AS, &limit);
+		}
+		execvp(argv[0], argv.data());
+		_exit(127);
+	}
+	// also set the process group here because we might signal the group before the child did it
+	if (pid > 0) setpgid(pid, pid);
+	close(to_solver[0]);
+	close(from_solver[1]);
+	if (dev_null >= 0) close(dev_null);
+	if (pid < 0) {
+		close(to_solver[1]);
+		close(from_solver[0]);
+		throw std::runtime_error(std::string("failed to start external solver: ")+std::strerror(errno));
+	}
+	int in_fd = to_solver[1];
+	int out_fd = from_solver[0];
+	fcntl(in_fd, F_SETFL, O_NONBLOCK);
+
+	// the DIMACS input is encoded chunk by chunk while the solver reads it
+	std::string input = "p cnf " + std::to_string(this->variable_counter) + " " + std::to_string(this->num_clauses + (long long)unit_literals.size()) + "\n";
+	size_t input_pos = 0;
+	size_t clause_pos = 0;
+	size_t unit_pos = 0;
+	auto refill_input = [&]() {
+		input.clear();
+		input_pos = 0;
+		char number[16];
+		while (input.size() < (1 << 16) and clause_pos < this->clauses.size()) {
+			auto lit = this->clauses[clause_pos++];
+			input.append(number, std::to_chars(number, number + sizeof(number), lit).ptr);
+			input.push_back(lit == 0 ? '\n' : ' ');
+		}
+		while (input.size() < (1 << 16) and clause_pos == this->clauses.size() and unit_pos < unit_literals.size()) {
+			input.append(number, std::to_chars(number, number + sizeof(number), unit_literals[unit_pos++]).ptr);
+			input.append(" 0\n");
+		}
+	};
+
+	this->model.assign(this->variable_counter+1, 0);
+	int status = 0;
+	std::string line;
+	char buffer[1 << 16];
+	auto start_time = std::chrono::steady_clock::now();
+	auto deadline = start_time + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(this->check_timeout));
+	auto signal_solver = [&](int sig) {
+		// fall back to the solver itself if it is not the leader of its own group (e.g., setpgid failed)
+		if (kill(-pid, sig) != 0) kill(pid, sig);
+	};
+	bool terminated = false;
+	bool killed = false;
+	std::chrono::steady_clock::time_point kill_time;
+	auto stop_solver = [&]() {
+		auto now = std::chrono::steady_clock::now();
+		if (!terminated and (this->interrupt_requested or now >= deadline)) {
+			// give the solver a chance to exit gracefully
+			signal_solver(SIGTERM);
+			terminated = true;
+			kill_time = now + std::chrono::seconds(1);
+		}
+		if (terminated and !killed and now >= kill_time) {
+			signal_solver(SIGKILL);
+			killed = true;
+		}
+	};
+	while (out_fd >= 0) {
+		stop_solver();
+		if (terminated and in_fd >= 0) {
+			close(in_fd);
+			in_fd = -1;
+		}
+		struct pollfd fds[2];
+		int num_fds = 0;
+		fds[num_fds++] = {out_fd, POLLIN, 0};
+		if (in_fd >= 0) fds[num_fds++] = {in_fd, POLLOUT, 0};
+		// wake up regularly to check for interrupts and the timeout
+		if (poll(fds, num_fds, 100) < 0) {
+			if (errno == EINTR) continue;
+			signal_solver(SIGKILL);
+			waitpid(pid, nullptr, 0);
+			throw std::runtime_error(std::string("failed to communicate with external solver: ")+std::strerror(errno));
+		}
+		if (in_fd >= 0 and fds[1].revents != 0) {
+			if (input_pos == input.size()) refill_input();
+			auto written = write(in_fd, input.data() + input_pos, input.size() - input_pos);
+			if (written > 0) input_pos += written;
+			// EPIPE -> the solver stopped reading (e.g., it crashed or found a trivial conflict)
+			bool failed = written < 0 and errno != EAGAIN and errno != EINTR;
+			if (failed or (input_pos == input.size() and clause_pos == this->clauses.size() and unit_pos == unit_literals.size())) {
+				// EOF tells the solver that the problem is complete
+				close(in_fd);
+				in_fd = -1;
+			}
+		}
+		if (fds[0].revents != 0) {
+			auto num_read = read(out_fd, buffer, sizeof(buffer));
+			if (num_read < 0 and (errno == EAGAIN or errno == EINTR)) continue;
+			if (num_read <= 0) {
+				close(out_fd);
+				out_fd = -1;
+				continue;
+			}
+			for (ssize_t i = 0; i < num_read; i++) {
+				if (buffer[i] != '\n') {
+					line.push_back(buffer[i]);
+					continue;
+				}
+				this->parse_output_line(line, status);
+				line.clear();
+			}
+		}
+	}
+	if (in_fd >= 0) close(in_fd);
+	if (!line.empty()) this->parse_output_line(line, status);
+	// the solver might still be running although it closed its stdout
+	int wait_status = 0;
+	while (waitpid(pid, &wait_status, WNOHANG) == 0) {
+		stop_solver();
+		usleep(10000);
+	}
+	if (status == 0 and WIFEXITED(wait_status)) {
+		auto exit_code = WEXITSTATUS(wait_status);
+		if (exit_code == 127 and !terminated) throw std::runtime_error("failed to execute external solver '"+this->command+"'");
+		if (exit_code == 10 or exit_code == 20) status = exit_code;
+	}
+	if (status == 0 and !terminated and !this->quiet) {
+		std::cout << "    external solver stopped without result (" << (WIFSIGNALED(wait_status) ? "signal "+std::to_string(WTERMSIG(wait_status)) : "exit code "+std::to_string(WEXITSTATUS(wait_status))) << ")" << std::endl;
+	}
+	auto sat = status == 10;
+	auto unsat = status == 20;
+	auto to = !sat and !unsat;
+	return {sat, to};
+}
+
+void scm_external::parse_output_line(const std::string &line, int &status) {
+	if (line.size() < 2 or line[1] != ' ') return;
+	if (line[0] == 's') {
+		if (line.compare(2, 11, "SATISFIABLE") == 0) status = 10;
+		else if (line.compare(2, 13, "UNSATISFIABLE") == 0) status = 20;
+	}
+	else if (line[0] == 'v') {
+		auto p = line.c_str() + 2;
+		auto end = line.c_str() + line.size();
+		while (p < end) {
+			while (p < end and *p == ' ') p++;
+			int lit = 0;
+			auto result = std::from_chars(p, end, lit);
+			if (result.ec != std::errc()) break;
+			p = result.ptr;
+			auto idx = std::abs(lit);
+			if (idx > 0 and idx < (int)this->model.size()) this->model[idx] = lit > 0 ? 1 : 0;
+		}
+	}
+}
+
+int scm_external::get_result_value(int var_idx) {
+	if (var_idx <= 0 or var_idx >= (int)this->model.size()) throw std::runtime_error("external solver did not report variable "+std::to_string(var_idx));
+	return this->model[var_idx];
+}
+
+bool scm_external::supports_assumptions() {
+	// the assumptions are passed as unit clauses (no UNSAT core -> assumption_failed always returns true)
+	return true;
+}
+
+std::unique_ptr<scm> scm_external::create_instance(const std::vector<int> &C) {
+	return std::make_unique<scm_external>(C, this->timeout, this->quiet, this->calc_twos_complement, this->write_cnf, this->command, this->memory_limit);
+}
+
+void scm_external::add_clause_to_backend(const int *literals, int num_literals) {
+	this->clauses.insert(this->clauses.end(), literals, literals+num_literals);
+	this->clauses.emplace_back(0);
+	this->num_clauses++;
+}
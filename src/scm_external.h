@@ -0,0 +1,63 @@
+//
+// Created by nfiege on 11/24/22.
+//
+
+#ifndef SATSCM_SCM_EXTERNAL_H
+#define SATSCM_SCM_EXTERNAL_H
+
+#include <scm.h>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+/*!
+ * runs an external DIMACS solver executable (e.g., kissat) for each SAT problem
+ * the problem is streamed to the solver's stdin and the model is parsed from the "s"/"v" lines of its stdout
+ * (the exit codes 10/20 are accepted as well)
+ * the solver is terminated with SIGTERM (and SIGKILL if it does not react) on timeout and interrupts
+ */
+class scm_external : public scm {
+public:
+	/*!
+	 * constructor
+	 * @param command executable and its arguments separated by spaces (the executable is searched in PATH)
+	 * @param memory_limit address space limit of the solver process in MB (0 = unlimited)
+	 */
+	scm_external(const std::vector<int> &C, int timeout, bool quiet, bool allow_negative_numbers, bool write_cnf, const std::string &command, long memory_limit = 0);
+
+protected:
+	std::pair<bool, bool> check() override;
+	void reset_backend(formulation_mode mode) override;
+	int get_result_value(int var_idx) override;
+	bool supports_assumptions() override;
+	std::unique_ptr<scm> create_instance(const std::vector<int> &C) override;
+
+	void add_clause_to_backend(const int *literals, int num_literals) override;
+
+private:
+	std::string command;
+	std::vector<std::string> arguments;
+	long memory_limit;
+	/*!
+	 * all clauses of the current problem in DIMACS format (each clause is terminated by 0)
+	 * the solver process only lives for one check() call, so it gets the whole problem every time
+	 */
+	std::vector<int> clauses;
+	/*!
+	 * number of clauses in this->clauses
+	 */
+	long long num_clauses = 0;
+	/*!
+	 * model of the last satisfiable problem (index = variable idx)
+	 */
+	std::vector<char> model;
+	/*!
+	 * parse one line of the solver output
+	 * @param line
+	 * @param status set to 10 for "s SATISFIABLE" and to 20 for "s UNSATISFIABLE"
+	 */
+	void parse_output_line(const std::string &line, int &status);
+};
+
+#endif //SATSCM_SCM_EXTERNAL_H
@@ -0,0 +1,82 @@
+//
+// Created by nfiege on 11/14/22.
+//
+
+#include "scm_factory.h"
+#include <stdexcept>
+#include <scm_portfolio.h>
+#include <scm_external.h>
+#include <scm_ipasir.h>
+
+#ifdef USE_CADICAL
+#include <scm_cadical.h>
+#endif
+
+#ifdef USE_Z3
+#include <scm_z3.h>
+#endif
+
+#ifdef USE_SYRUP
+#include <scm_syrup.h>
+#endif
+
+std::unique_ptr<scm> create_scm(const std::string &solver_name, const std::vector<int> &C, int timeout, bool quiet, int threads, bool allow_negative_numbers, bool write_cnf) {
+	if (solver_name == "cadical") {
+#ifdef USE_CADICAL
+		return std::make_unique<scm_cadical>(C, timeout, quiet, allow_negative_numbers, write_cnf);
+#else
+		throw std::runtime_error("Link CaDiCaL lib to use CaDiCaL backend");
+#endif
+	}
+	else if (solver_name == "syrup" or solver_name == "glucose" or solver_name == "glucose-syrup") {
+#ifdef USE_SYRUP
+		return std::make_unique<scm_syrup>(C, timeout, quiet, threads, allow_negative_numbers, write_cnf);
+#else
+		throw std::runtime_error("Link Glucose-Syrup lib to use syrup backend");
+#endif
+	}
+	else if (solver_name == "z3") {
+#ifdef USE_Z3
+		return std::make_unique<scm_z3>(C, timeout, quiet, threads, allow_negative_numbers, write_cnf);
+#else
+		throw std::runtime_error("Link Z3 lib to use Z3 backend");
+#endif
+	}
+	else if (solver_name == "portfolio") {
+		return std::make_unique<scm_portfolio>(C, timeout, quiet, threads, allow_negative_numbers, write_cnf);
+	}
+	else if (solver_name.rfind("ipasir:", 0) == 0) {
+		return std::make_unique<scm_ipasir>(C, timeout, quiet, allow_negative_numbers, write_cnf, solver_name.substr(7));
+	}
+	else if (solver_name.rfind("external", 0) == 0) {
+		// external:<command> or external@<memory limit in MB>:<command>
+		auto colon = solver_name.find(':');
+		if (colon == std::string::npos) throw std::runtime_error("external solver needs a command, e.g., external:kissat");
+		long memory_limit = 0;
+		if (solver_name[8] == '@') {
+			try {
+				memory_limit = std::stol(solver_name.substr(9, colon-9));
+			}
+			catch (...) {
+				throw std::runtime_error("failed to convert the memory limit in '"+solver_name+"' to integer");
+			}
+		}
+		else if (colon != 8) throw std::runtime_error("unknown solver name '"+solver_name+"'");
+		return std::make_unique<scm_external>(C, timeout, quiet, allow_negative_numbers, write_cnf, solver_name.substr(colon+1), memory_limit);
+	}
+	throw std::runtime_error("unknown solver name '"+solver_name+"'");
+}
+
+std::vector<std::string> get_available_backends() {
+	std::vector<std::string> backends;
+#ifdef USE_CADICAL
+	backends.emplace_back("cadical");
+#endif
+#ifdef USE_SYRUP
+	backends.emplace_back("syrup");
+#endif
+#ifdef USE_Z3
+	backends.emplace_back("z3");
+#endif
+	return backends;
+}
@@ -0,0 +1,33 @@
+//
+// Created by nfiege on 11/14/22.
+//
+
+#ifndef SATSCM_SCM_FACTORY_H
+#define SATSCM_SCM_FACTORY_H
+
+#include <scm.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+/*!
+ * create an scm instance that uses the requested backend
+ * @param solver_name cadical, z3, syrup (glucose, glucose-syrup), portfolio
+ *   or ipasir:<shared library> for an IPASIR solver library that is loaded at runtime
+ *   or external:<command> / external@<memory limit in MB>:<command> for a DIMACS solver executable
+ * @param C the constant(s) we want to compute
+ * @param timeout in seconds
+ * @param quiet true/false
+ * @param threads the number of CPU threads the backend is allowed to use
+ * @param allow_negative_numbers true/false
+ * @param write_cnf true/false
+ * @return the instance (throws if the backend is unknown or not linked)
+ */
+std::unique_ptr<scm> create_scm(const std::string &solver_name, const std::vector<int> &C, int timeout, bool quiet, int threads, bool allow_negative_numbers, bool write_cnf);
+
+/*!
+ * @return names of all backends that were linked into this binary (best backend first)
+ */
+std::vector<std::string> get_available_backends();
+
+#endif //SATSCM_SCM_FACTORY_H
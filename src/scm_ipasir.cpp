@@ -0,0 +1,104 @@
+//
+// Created by nfiege on 11/25/22.
+//
+
+#include "scm_ipasir.h"
+#include <iostream>
+#include <stdexcept>
+#include <dlfcn.h>
+
+template <typename T>
+static void load_function(void *handle, const std::string &filename, const char *name, T &function) {
+	function = reinterpret_cast<T>(dlsym(handle, name));
+	if (function == nullptr) throw std::runtime_error(filename+" is not an IPASIR library (missing "+name+")");
+}
+
+ipasir_library::ipasir_library(const std::string &filename) : filename(filename) {
+	// RTLD_LOCAL -> several IPASIR libraries don't clash
+	this->handle = dlopen(filename.c_str(), RTLD_NOW | RTLD_LOCAL);
+	if (this->handle == nullptr) throw std::runtime_error("failed to load "+filename+": "+dlerror());
+	try {
+		load_function(this->handle, filename, "ipasir_signature", this->signature);
+		load_function(this->handle, filename, "ipasir_init", this->init);
+		load_function(this->handle, filename, "ipasir_release", this->release);
+		load_function(this->handle, filename, "ipasir_add", this->add);
+		load_function(this->handle, filename, "ipasir_assume", this->assume);
+		load_function(this->handle, filename, "ipasir_solve", this->solve);
+		load_function(this->handle, filename, "ipasir_val", this->val);
+		load_function(this->handle, filename, "ipasir_failed", this->failed);
+		load_function(this->handle, filename, "ipasir_set_terminate", this->set_terminate);
+	}
+	catch (...) {
+		dlclose(this->handle);
+		throw;
+	}
+}
+
+ipasir_library::~ipasir_library() {
+	dlclose(this->handle);
+}
+
+scm_ipasir::scm_ipasir(const std::vector<int> &C, int timeout, bool quiet, bool allow_negative_numbers, bool write_cnf, const std::string &library_filename)
+	: scm_ipasir(C, timeout, quiet, allow_negative_numbers, write_cnf, std::make_shared<const ipasir_library>(library_filename)) {
+	if (!this->quiet) std::cout << "using IPASIR solver " << this->library->signature() << std::endl;
+}
+
+scm_ipasir::scm_ipasir(const std::vector<int> &C, int timeout, bool quiet, bool allow_negative_numbers, bool write_cnf, std::shared_ptr<const ipasir_library> library)
+	: scm(C, timeout, quiet, 1, allow_negative_numbers, write_cnf), library(std::move(library)) {}
+
+scm_ipasir::~scm_ipasir() {
+	if (this->solver != nullptr) this->library->release(this->solver);
+}
+
+void scm_ipasir::reset_backend(formulation_mode mode) {
+	scm::reset_backend(mode);
+	if (mode != formulation_mode::reset_all) return;
+	// create new solver
+	if (this->solver != nullptr) this->library->release(this->solver);
+	this->solver = this->library->init();
+	this->library->set_terminate(this->solver, this, &scm_ipasir::terminate);
+}
+
+std::pair<bool, bool> scm_ipasir::check() {
+	if (this->interrupt_requested) return {false, true};
+	// the timeout applies to each call separately (the solver might be reused in incremental mode)
+	this->solve_start = std::chrono::steady_clock::now();
+	for (auto &it : this->assumptions) {
+		this->library->assume(this->solver, it.second?-it.first:it.first);
+	}
+	auto stat = this->library->solve(this->solver);
+	auto sat = stat == IPASIR_SAT;
+	auto unsat = stat == IPASIR_UNSAT;
+	auto to = !sat and !unsat;
+	return {sat, to};
+}
+
+int scm_ipasir::terminate(void *data) {
+	auto instance = static_cast<scm_ipasir*>(data);
+	if (instance->interrupt_requested) return 1;
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - instance->solve_start).count() >= instance->check_timeout ? 1 : 0;
+}
+
+bool scm_ipasir::supports_assumptions() {
+	return true;
+}
+
+bool scm_ipasir::assumption_failed(const std::pair<int, bool> &assumption) {
+	return this->library->failed(this->solver, assumption.second?-assumption.first:assumption.first) != 0;
+}
+
+std::unique_ptr<scm> scm_ipasir::create_instance(const std::vector<int> &C) {
+	return std::unique_ptr<scm>(new scm_ipasir(C, this->timeout, this->quiet, this->calc_twos_complement, this->write_cnf, this->library));
+}
+
+int scm_ipasir::get_result_value(int var_idx) {
+	// 0 -> the variable is irrelevant for the model
+	return this->library->val(this->solver, var_idx) > 0 ? 1 : 0;
+}
+
+void scm_ipasir::add_clause_to_backend(const int *literals, int num_literals) {
+	for (int i = 0; i < num_literals; i++) {
+		this->library->add(this->solver, literals[i]);
+	}
+	this->library->add(this->solver, 0);
+}
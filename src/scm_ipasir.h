@@ -0,0 +1,81 @@
+//
+// Created by nfiege on 11/25/22.
+//
+
+#ifndef SATSCM_SCM_IPASIR_H
+#define SATSCM_SCM_IPASIR_H
+
+#include <scm.h>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+/*!
+ * function pointers of an IPASIR solver library that was loaded with dlopen
+ */
+struct ipasir_library {
+	/*!
+	 * load the library and look up all IPASIR functions (throws if that fails)
+	 */
+	explicit ipasir_library(const std::string &filename);
+	~ipasir_library();
+	ipasir_library(const ipasir_library &) = delete;
+	ipasir_library &operator=(const ipasir_library &) = delete;
+	std::string filename;
+	void *handle = nullptr;
+	const char *(*signature)() = nullptr;
+	void *(*init)() = nullptr;
+	void (*release)(void *solver) = nullptr;
+	void (*add)(void *solver, int lit_or_zero) = nullptr;
+	void (*assume)(void *solver, int lit) = nullptr;
+	int (*solve)(void *solver) = nullptr;
+	int (*val)(void *solver, int lit) = nullptr;
+	int (*failed)(void *solver, int lit) = nullptr;
+	void (*set_terminate)(void *solver, void *data, int (*terminate)(void *data)) = nullptr;
+};
+
+/*!
+ * incremental backend for any solver that implements the IPASIR interface
+ * the shared library is chosen at runtime, e.g., ipasir:/path/to/libipasircadical.so
+ */
+class scm_ipasir : public scm {
+
+#define IPASIR_SAT 10
+#define IPASIR_UNSAT 20
+
+public:
+	/*!
+	 * constructor
+	 * @param library_filename path of the IPASIR shared library
+	 */
+	scm_ipasir(const std::vector<int> &C, int timeout, bool quiet, bool allow_negative_numbers, bool write_cnf, const std::string &library_filename);
+	~scm_ipasir() override;
+
+protected:
+	std::pair<bool, bool> check() override;
+	void reset_backend(formulation_mode mode) override;
+	int get_result_value(int var_idx) override;
+	bool supports_assumptions() override;
+	bool assumption_failed(const std::pair<int, bool> &assumption) override;
+	std::unique_ptr<scm> create_instance(const std::vector<int> &C) override;
+
+	void add_clause_to_backend(const int *literals, int num_literals) override;
+
+private:
+	/*!
+	 * shared with all instances created by this->create_instance(...)
+	 */
+	std::shared_ptr<const ipasir_library> library;
+	void *solver = nullptr;
+	std::chrono::steady_clock::time_point solve_start;
+	/*!
+	 * @param data the scm_ipasir instance
+	 * @return 1 if the solver should stop because of a timeout or an interrupt
+	 */
+	static int terminate(void *data);
+	scm_ipasir(const std::vector<int> &C, int timeout, bool quiet, bool allow_negative_numbers, bool write_cnf, std::shared_ptr<const ipasir_library> library);
+};
+
+#endif //SATSCM_SCM_IPASIR_H
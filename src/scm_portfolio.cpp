@@ -0,0 +1,135 @@
+//
+// Created by nfiege on 11/14/22.
+//
+
+#include "scm_portfolio.h"
+#include <scm_factory.h>
+#include <iostream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <stdexcept>
+#include <cstdlib>
+
+scm_portfolio::scm_portfolio(const std::vector<int> &C, int timeout, bool quiet, int threads, bool allow_negative_numbers, bool write_cnf)
+	: scm(C, timeout, quiet, threads, allow_negative_numbers, write_cnf) {
+	auto backends = get_available_backends();
+	if (backends.empty()) throw std::runtime_error("Link at least one SAT solver lib to use the portfolio backend");
+	int num_workers = threads > 1 ? threads : (int)backends.size();
+	for (int i = 0; i < num_workers; i++) {
+		// use each backend once and fill the remaining slots with differently seeded instances of the best one
+		auto &name = i < (int)backends.size() ? backends[i] : backends.front();
+		// the workers only solve the problems we pass to them -> never let them print or write anything
+		this->workers.emplace_back(create_scm(name, C, timeout, true, 1, allow_negative_numbers, false));
+		if (i >= (int)backends.size()) this->workers.back()->set_random_seed(i);
+		this->worker_names.emplace_back(name);
+	}
+	this->worker_clause_position.assign(this->workers.size(), 0);
+	this->worker_phase_position.assign(this->workers.size(), 0);
+}
+
+std::pair<bool, bool> scm_portfolio::check() {
+	if (this->interrupt_requested) return {false, true};
+	this->winner = -1;
+	std::mutex result_mutex;
+	std::condition_variable result_cv;
+	std::pair<bool, bool> result = {false, true};
+	int num_finished = 0;
+	std::vector<bool> worker_finished(this->workers.size(), false);
+	int num_workers = (int)this->workers.size();
+	std::vector<std::thread> worker_threads;
+	for (int i = 0; i < num_workers; i++) {
+		worker_threads.emplace_back([&, i]() {
+			auto &worker = this->workers[i];
+			// only pass on what changed since the last call so that the worker keeps what it learned
+			// (a worker that is extended stays in the clause exchange of this problem)
+			auto &clause_position = this->worker_clause_position[i];
+			auto &phase_position = this->worker_phase_position[i];
+			if (clause_position == 0 or !worker->extend_cnf(this->variable_counter, this->clauses.data()+clause_position, this->clauses.size()-clause_position)) {
+				worker->share_learned_clauses(this->exchange);
+				worker->load_cnf(this->variable_counter, this->clauses);
+				phase_position = 0;
+			}
+			clause_position = this->clauses.size();
+			for (; phase_position < this->phases.size(); phase_position++) {
+				auto lit = this->phases[phase_position];
+				worker->set_cnf_phase(std::abs(lit), lit > 0);
+			}
+			auto worker_result = worker->solve_cnf(this->assumptions, this->check_timeout);
+			{
+				std::lock_guard<std::mutex> lock(result_mutex);
+				num_finished++;
+				worker_finished[i] = true;
+				// only a definite answer (SAT or UNSAT) counts -> the others keep on trying after a timeout
+				if (!worker_result.second and this->winner < 0) {
+					this->winner = i;
+					result = worker_result;
+				}
+			}
+			result_cv.notify_all();
+		});
+	}
+	{
+		std::unique_lock<std::mutex> lock(result_mutex);
+		while (num_finished < num_workers) {
+			if (this->winner >= 0 or this->interrupt_requested) {
+				// interrupt all remaining workers
+				// repeat this until they are done because a worker might not have started solving yet
+				for (int i = 0; i < num_workers; i++) {
+					if (!worker_finished[i]) this->workers[i]->interrupt();
+				}
+			}
+			result_cv.wait_for(lock, std::chrono::milliseconds(10));
+		}
+	}
+	for (auto &t : worker_threads) {
+		t.join();
+	}
+	if (!this->quiet and this->winner >= 0) std::cout << "    portfolio: worker " << this->winner << " (" << this->worker_names[this->winner] << ") was the fastest" << std::endl;
+	return result;
+}
+
+void scm_portfolio::reset_backend(formulation_mode mode) {
+	scm::reset_backend(mode);
+	if (mode != formulation_mode::reset_all) return;
+	this->clauses.clear();
+	this->phases.clear();
+	this->worker_clause_position.assign(this->workers.size(), 0);
+	this->worker_phase_position.assign(this->workers.size(), 0);
+	// all workers solve the same problem -> they can share what they learn about it
+	this->exchange = this->workers.size() > 1 ? std::make_shared<clause_exchange>() : nullptr;
+	this->winner = -1;
+}
+
+int scm_portfolio::get_result_value(int var_idx) {
+	return this->workers[this->winner]->get_cnf_value(var_idx);
+}
+
+bool scm_portfolio::supports_assumptions() {
+	// assumptions are passed to the workers (which force them as unit clauses if they can't handle assumptions)
+	return true;
+}
+
+bool scm_portfolio::assumption_failed(const std::pair<int, bool> &assumption) {
+	return this->workers[this->winner]->cnf_assumption_failed(assumption);
+}
+
+void scm_portfolio::interrupt_backend() {
+	for (auto &worker : this->workers) {
+		worker->interrupt();
+	}
+}
+
+std::unique_ptr<scm> scm_portfolio::create_instance(const std::vector<int> &C) {
+	return std::make_unique<scm_portfolio>(C, this->timeout, this->quiet, this->threads, this->calc_twos_complement, this->write_cnf);
+}
+
+void scm_portfolio::set_preferred_phase(int var_idx, bool value) {
+	this->phases.emplace_back(value?var_idx:-var_idx);
+}
+
+void scm_portfolio::add_clause_to_backend(const int *literals, int num_literals) {
+	this->clauses.insert(this->clauses.end(), literals, literals+num_literals);
+	this->clauses.emplace_back(0);
+}
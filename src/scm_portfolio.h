@@ -0,0 +1,72 @@
+//
+// Created by nfiege on 11/14/22.
+//
+
+#ifndef SATSCM_SCM_PORTFOLIO_H
+#define SATSCM_SCM_PORTFOLIO_H
+
+#include <scm.h>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+/*!
+ * runs several backends (or differently seeded instances of the same backend) on the same problem in parallel
+ * the first backend that finds an answer wins and all others are interrupted
+ */
+class scm_portfolio : public scm {
+public:
+	/*!
+	 * constructor
+	 * @param threads number of backend instances that run in parallel (each instance uses one thread)
+	 *   -> if threads <= 1, one instance of each available backend is used
+	 */
+	scm_portfolio(const std::vector<int> &C, int timeout, bool quiet, int threads, bool allow_negative_numbers, bool write_cnf);
+
+protected:
+	std::pair<bool, bool> check() override;
+	void reset_backend(formulation_mode mode) override;
+	int get_result_value(int var_idx) override;
+	bool supports_assumptions() override;
+	bool assumption_failed(const std::pair<int, bool> &assumption) override;
+	void interrupt_backend() override;
+	std::unique_ptr<scm> create_instance(const std::vector<int> &C) override;
+	void set_preferred_phase(int var_idx, bool value) override;
+
+	void add_clause_to_backend(const int *literals, int num_literals) override;
+
+private:
+	/*!
+	 * the backend instances that compete against each other
+	 */
+	std::vector<std::unique_ptr<scm>> workers;
+	/*!
+	 * names of the backends in this->workers (for debug outputs)
+	 */
+	std::vector<std::string> worker_names;
+	/*!
+	 * index of the worker that produced the last result (-1 if none)
+	 */
+	int winner = -1;
+	/*!
+	 * all clauses of the current problem in DIMACS format (each clause is terminated by 0)
+	 */
+	std::vector<int> clauses;
+	/*!
+	 * preferred phases of the current problem in DIMACS format (they are passed on to the workers)
+	 */
+	std::vector<int> phases;
+	/*!
+	 * how much of this->clauses and this->phases each worker already knows
+	 * (0 clauses -> the worker must load the problem from scratch)
+	 */
+	std::vector<size_t> worker_clause_position;
+	std::vector<size_t> worker_phase_position;
+	/*!
+	 * learned clauses of the workers (one exchange for each problem that is loaded from scratch)
+	 */
+	std::shared_ptr<clause_exchange> exchange;
+};
+
+#endif //SATSCM_SCM_PORTFOLIO_H
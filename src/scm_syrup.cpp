@@ -7,35 +7,59 @@
 #ifdef USE_SYRUP
 #include <iostream>
 #include <cstdlib>
+#include <thread>
 #include <mtl/Vec.h>
 
 scm_syrup::scm_syrup(const std::vector<int> &C, int timeout, bool quiet, int threads, bool allow_negative_numbers, bool write_cnf)
 	: scm(C, timeout, quiet, threads, allow_negative_numbers, write_cnf) {}
 
-void *scm_syrup::timeout_thread(std::pair<int, pthread_t*>* p) {
-	sleep(p->first); // first argument: timeout
-	pthread_cancel(*p->second); // second argument: thread to cancel
-	return nullptr;
-}
-
-void *scm_syrup::worker_thread(std::pair<scm_syrup*, pthread_t*>* p) {
-	auto result = p->first->solver->solve();
-	p->first->solved_instance = result == l_True;
-	p->first->ran_into_timeout = result == l_Undef;
-	pthread_cancel(*p->second); // second argument: thread to cancel
-	return nullptr;
+void scm_syrup::worker_thread(scm_syrup* p) {
+	auto result = p->solver->solve();
+	{
+		std::lock_guard<std::mutex> lock(p->worker_thread_mutex);
+		p->solved_instance = result == l_True;
+		p->ran_into_timeout = result == l_Undef;
+		p->worker_finished = true;
+	}
+	p->worker_thread_cv.notify_all();
 }
 
 std::pair<bool, bool> scm_syrup::check() {
-	// use pthread to handle timeout (dirty but ok I guess)
-	std::pair <int, pthread_t*> timeout_args = {this->timeout, &this->worker_thread_id};
-	std::pair <scm_syrup*, pthread_t*> worker_args = {this, &this->timeout_thread_id};
-	pthread_create(&this->timeout_thread_id, nullptr, reinterpret_cast<void *(*)(void *)>(&scm_syrup::timeout_thread), &timeout_args);
-	pthread_create(&this->worker_thread_id, nullptr, reinterpret_cast<void *(*)(void *)>(&scm_syrup::worker_thread), &worker_args);
-	pthread_join(this->worker_thread_id, nullptr);
+	// the solver reports a timeout if it is interrupted
+	this->solved_instance = false;
+	this->ran_into_timeout = true;
+	this->worker_finished = false;
+	std::thread worker;
+	{
+		std::lock_guard<std::mutex> lock(this->worker_thread_mutex);
+		if (this->interrupt_requested) return {false, true};
+		// an interrupt of the last call must not stop this one
+		this->solver->clearInterrupt();
+		worker = std::thread(&scm_syrup::worker_thread, this);
+	}
+	auto deadline = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(this->check_timeout));
+	{
+		std::unique_lock<std::mutex> lock(this->worker_thread_mutex);
+		this->worker_thread_cv.wait_until(lock, deadline, [this]() { return this->worker_finished or this->interrupt_requested; });
+		// the solver threads check the interrupt flag regularly and return l_Undef
+		if (!this->worker_finished) this->solver->interrupt();
+	}
+	worker.join();
 	return {this->solved_instance, this->ran_into_timeout};
 }
 
+void scm_syrup::interrupt_backend() {
+	// wake up check() which interrupts the solver
+	{
+		std::lock_guard<std::mutex> lock(this->worker_thread_mutex);
+	}
+	this->worker_thread_cv.notify_all();
+}
+
+std::unique_ptr<scm> scm_syrup::create_instance(const std::vector<int> &C) {
+	return std::make_unique<scm_syrup>(C, this->timeout, this->quiet, this->threads, this->calc_twos_complement, this->write_cnf);
+}
+
 void scm_syrup::reset_backend(formulation_mode mode) {
 	scm::reset_backend(mode);
 	if (mode != formulation_mode::reset_all) return;
@@ -51,15 +75,14 @@ int scm_syrup::get_result_value(int var_idx) {
 	return 0;
 }
 
-void scm_syrup::create_arbitrary_clause(const std::vector<std::pair<int, bool>> &a) {
-	scm::create_arbitrary_clause(a);
-	Glucose::vec<Glucose::Lit> literals;
-	for (auto &it : a) {
-		auto var = it.first-1;
-		if (it.second) literals.push(~Glucose::mkLit(var)); // negate variable
-		else literals.push(Glucose::mkLit(var)); // do not negate
+void scm_syrup::add_clause_to_backend(const int *literals, int num_literals) {
+	// keep the memory of the literal vector between clauses
+	this->clause_literals.clear(false);
+	for (int i = 0; i < num_literals; i++) {
+		auto var = std::abs(literals[i])-1; // internally, glucose starts with idx 0 for the first variable
+		this->clause_literals.push(Glucose::mkLit(var, literals[i] < 0));
 	}
-	this->solver->addClause(literals);
+	this->solver->addClause(this->clause_literals);
 }
 
 void scm_syrup::create_new_variable(int idx) {
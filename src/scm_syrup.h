@@ -14,7 +14,8 @@
 #include <memory>
 #include <utility>
 #include <vector>
-#include <pthread.h>
+#include <mutex>
+#include <condition_variable>
 
 
 class scm_syrup : public scm {
@@ -26,17 +27,32 @@ protected:
 	void reset_backend(formulation_mode mode) override;
 	int get_result_value(int var_idx) override;
 	void create_new_variable(int idx) override;
+	void interrupt_backend() override;
+	std::unique_ptr<scm> create_instance(const std::vector<int> &C) override;
 
-	void create_arbitrary_clause(const std::vector<std::pair<int, bool>> &a) override;
+	void add_clause_to_backend(const int *literals, int num_literals) override;
 
 private:
 	std::unique_ptr<Glucose::MultiSolvers> solver;
+	/*!
+	 * reused for passing clauses to the solver
+	 */
+	Glucose::vec<Glucose::Lit> clause_literals;
 	int glucoseVariableCounter = -1;
 
-	static void* timeout_thread(std::pair<int, pthread_t*>* p);
-	static void* worker_thread(std::pair<scm_syrup*, pthread_t*>* p);
-	pthread_t worker_thread_id = 0;
-	pthread_t timeout_thread_id = 0;
+	/*!
+	 * runs the solver in its own thread so that check() can interrupt it after the timeout
+	 */
+	static void worker_thread(scm_syrup* p);
+	/*!
+	 * guards worker_finished and the solver's interrupt flag against interrupts from other threads
+	 */
+	std::mutex worker_thread_mutex;
+	/*!
+	 * notified when the worker thread finished or an interrupt arrived
+	 */
+	std::condition_variable worker_thread_cv;
+	bool worker_finished = false;
 
 	bool ran_into_timeout = false;
 	bool solved_instance = false;
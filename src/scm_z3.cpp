@@ -3,18 +3,57 @@
 //
 
 #include "scm_z3.h"
+#include <cmath>
 
 #ifdef USE_Z3
 
 scm_z3::scm_z3(const std::vector<int> &C, int timeout, bool quiet, int threads, bool allow_negative_numbers, bool write_cnf)
-	:	scm(C, timeout, quiet, threads, allow_negative_numbers, write_cnf), solver(this->context) {}
+	:	scm(C, timeout, quiet, threads, allow_negative_numbers, write_cnf) {
+	this->context = std::make_unique<z3::context>();
+	this->solver = std::make_unique<z3::solver>(*this->context);
+}
 
 std::pair<bool, bool> scm_z3::check() {
-	if (this->timeout > 0) {
-		this->solver.set("timeout", (unsigned int)this->timeout*1000);
+	{
+		std::lock_guard<std::mutex> lock(this->context_mutex);
+		if (this->interrupt_requested) return {false, true};
+		this->solving = true;
+	}
+	z3::check_result stat;
+	try {
+		if (this->random_seed != 0) {
+			this->solver->set("random_seed", (unsigned int)this->random_seed);
+		}
+		if (this->check_timeout > 0) {
+			this->solver->set("timeout", (unsigned int)std::ceil(this->check_timeout*1000));
+		}
+		this->solver->set("threads", (unsigned int)this->threads);
+		// z3 would otherwise replace our SIGINT handler while solving
+		this->solver->set("ctrl_c", false);
+		z3::expr_vector assumption_literals(*this->context);
+		for (auto &it : this->assumptions) {
+			if (it.second) {
+				assumption_literals.push_back(not this->variables.at(it.first));
+			}
+			else {
+				assumption_literals.push_back(this->variables.at(it.first));
+			}
+		}
+		stat = this->solver->check(assumption_literals);
+	}
+	catch (z3::exception &e) {
+		std::lock_guard<std::mutex> lock(this->context_mutex);
+		this->solving = false;
+		// z3 throws if it is interrupted at the wrong moment
+		if (this->interrupt_requested) return {false, true};
+		throw;
+	}
+	{
+		std::lock_guard<std::mutex> lock(this->context_mutex);
+		this->solving = false;
+		// the context is unusable (e.g., for reading the model) after an interrupt
+		if (this->interrupt_requested) return {false, true};
 	}
-	this->solver.set("threads", (unsigned int)this->threads);
-	auto stat = this->solver.check();
 	auto sat = stat == z3::sat;
 	auto unsat = stat == z3::unsat;
 	auto to = !sat and !unsat;
@@ -24,39 +63,59 @@ std::pair<bool, bool> scm_z3::check() {
 void scm_z3::reset_backend(formulation_mode mode) {
 	scm::reset_backend(mode);
 	if (mode != formulation_mode::reset_all) return;
-	this->solver.reset();
 	this->variables.clear();
-	this->variables.emplace_back(this->context.bool_const("dummy")); // reset variables and add a dummy expression because indices start at 1
+	this->solver.reset();
+	{
+		std::lock_guard<std::mutex> lock(this->context_mutex);
+		this->context = std::make_unique<z3::context>();
+	}
+	this->solver = std::make_unique<z3::solver>(*this->context);
+	this->variables.emplace_back(this->context->bool_const("dummy")); // reset variables and add a dummy expression because indices start at 1
+}
+
+bool scm_z3::supports_assumptions() {
+	return true;
+}
+
+bool scm_z3::assumption_failed(const std::pair<int, bool> &assumption) {
+	auto core = this->solver->unsat_core();
+	for (unsigned i=0; i<core.size(); i++) {
+		auto literal = core[i];
+		bool negated = literal.is_not();
+		if (negated) literal = literal.arg(0);
+		if (negated == assumption.second and z3::eq(literal, this->variables.at(assumption.first))) return true;
+	}
+	return false;
+}
+
+void scm_z3::interrupt_backend() {
+	// only interrupt z3 while it is solving, otherwise it would throw on the next API call
+	std::lock_guard<std::mutex> lock(this->context_mutex);
+	if (this->solving) this->context->interrupt();
+}
+
+std::unique_ptr<scm> scm_z3::create_instance(const std::vector<int> &C) {
+	return std::make_unique<scm_z3>(C, this->timeout, this->quiet, this->threads, this->calc_twos_complement, this->write_cnf);
 }
 
 int scm_z3::get_result_value(int var_idx) {
-	return this->solver.get_model().eval(this->variables.at(var_idx)).is_true()?1:0;
+	return this->solver->get_model().eval(this->variables.at(var_idx)).is_true()?1:0;
 }
 
 void scm_z3::create_new_variable(int idx) {
 	auto name = std::to_string(idx);
-	this->variables.emplace_back(this->context.bool_const(name.c_str()));
+	this->variables.emplace_back(this->context->bool_const(name.c_str()));
 }
 
-void scm_z3::create_arbitrary_clause(const std::vector<std::pair<int, bool>> &a) {
-	scm::create_arbitrary_clause(a);
-	z3::expr e(this->context);
-	if (a.at(0).second) {
-		e = not this->variables.at(a.at(0).first);
-	}
-	else {
-		e = this->variables.at(a.at(0).first);
-	}
-	for (int i=1; i<a.size(); i++) {
-		auto &it = a.at(i);
-		if (it.second) {
-			e = e or (not this->variables.at(it.first));
-		}
-		else {
-			e = e or this->variables.at(it.first);
-		}
+void scm_z3::add_clause_to_backend(const int *literals, int num_literals) {
+	// build one n-ary disjunction instead of a chain of binary ones
+	z3::expr_vector e(*this->context);
+	for (int i = 0; i < num_literals; i++) {
+		auto &x = this->variables.at(std::abs(literals[i]));
+		if (literals[i] < 0) e.push_back(not x);
+		else e.push_back(x);
 	}
-	this->solver.add(e);
+	this->solver->add(z3::mk_or(e));
 }
 
 #endif //USE_Z3
\ No newline at end of file
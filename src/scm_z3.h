@@ -9,10 +9,13 @@
 
 #include <scm.h>
 #include <z3++.h>
+#include <z3_version.h>
+#include <cstdlib>
 #include <chrono>
 #include <memory>
 #include <utility>
 #include <vector>
+#include <mutex>
 
 
 class scm_z3 : public scm {
@@ -23,14 +26,30 @@ protected:
 	std::pair<bool, bool> check() override;
 	void reset_backend(formulation_mode mode) override;
 	int get_result_value(int var_idx) override;
+	bool supports_assumptions() override;
+	bool assumption_failed(const std::pair<int, bool> &assumption) override;
+	void interrupt_backend() override;
+	std::unique_ptr<scm> create_instance(const std::vector<int> &C) override;
 	void create_new_variable(int idx) override;
 
-	void create_arbitrary_clause(const std::vector<std::pair<int, bool>> &a) override;
+	void add_clause_to_backend(const int *literals, int num_literals) override;
 
 private:
-	z3::context context;
-	z3::solver solver;
+	/*!
+	 * a new context is created for each new problem
+	 * because an interrupt that arrives after a check() finished is still pending in the old context
+	 */
+	std::unique_ptr<z3::context> context;
+	std::unique_ptr<z3::solver> solver;
 	std::vector<z3::expr> variables;
+	/*!
+	 * guards this->context and this->solving against interrupts from other threads
+	 */
+	std::mutex context_mutex;
+	/*!
+	 * whether this->solver->check() is currently running
+	 */
+	bool solving = false;
 };
 
 #endif //USE_Z3
@@ -0,0 +1,48 @@
+//
+// Created by nfiege on 11/28/22.
+//
+
+#include "time_budget.h"
+#include <algorithm>
+#include <limits>
+
+time_budget::time_budget(double seconds, double adder_phase_share) : seconds(seconds), adder_phase_share(adder_phase_share) {}
+
+time_budget::clock::time_point time_budget::after(double seconds) {
+	// one year is plenty and can't overflow
+	if (seconds > 365.0*24*3600) return clock::time_point::max();
+	return clock::now() + std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(seconds));
+}
+
+double time_budget::seconds_until(clock::time_point t) {
+	if (t == clock::time_point::max()) return std::numeric_limits<double>::infinity();
+	return std::max(0.0, std::chrono::duration<double>(t - clock::now()).count());
+}
+
+void time_budget::start() {
+	this->start_time = clock::now();
+	this->deadline = this->is_limited() ? after(this->seconds) : clock::time_point::max();
+	this->phase_deadline = this->deadline;
+}
+
+void time_budget::reserve_full_adder_phase() {
+	if (!this->is_limited()) return;
+	auto share = std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(this->adder_phase_share * this->seconds));
+	this->phase_deadline = std::min(this->deadline, this->start_time + share);
+}
+
+void time_budget::start_full_adder_phase(double max_seconds) {
+	this->phase_deadline = std::min(this->deadline, after(max_seconds));
+}
+
+double time_budget::get_slice(double per_call_timeout) const {
+	return std::min(per_call_timeout, seconds_until(this->phase_deadline));
+}
+
+bool time_budget::expired() const {
+	return seconds_until(this->phase_deadline) <= 0.0;
+}
+
+bool time_budget::is_limited() const {
+	return this->seconds > 0.0;
+}
@@ -0,0 +1,75 @@
+//
+// Created by nfiege on 11/28/22.
+//
+
+#ifndef SATSCM_TIME_BUDGET_H
+#define SATSCM_TIME_BUDGET_H
+
+#include <chrono>
+
+/*!
+ * splits a total wall-clock budget between the adder count phase and the full adder phase of scm::solve
+ * and hands out the time for each SAT call based on absolute deadlines
+ * without a total budget, only the per-call timeouts and the limit of the full adder phase apply
+ */
+class time_budget {
+public:
+	/*!
+	 * constructor
+	 * @param seconds total wall-clock budget (<= 0 -> unlimited)
+	 * @param adder_phase_share fraction of the budget for the adder count phase if the full adder phase follows
+	 *   (time that the adder count phase does not need is left for the full adder phase)
+	 */
+	explicit time_budget(double seconds = 0.0, double adder_phase_share = 0.8);
+	/*!
+	 * start the clock and the adder count phase (it may use the whole budget until this->reserve_full_adder_phase is called)
+	 */
+	void start();
+	/*!
+	 * end the adder count phase after its share of the budget
+	 * -> the rest is left for the full adder phase
+	 */
+	void reserve_full_adder_phase();
+	/*!
+	 * start the full adder phase which gets the rest of the budget
+	 * @param max_seconds upper limit for the whole phase (also applies without total budget)
+	 */
+	void start_full_adder_phase(double max_seconds);
+	/*!
+	 * @param per_call_timeout upper limit for a single SAT call
+	 * @return time in seconds for the next SAT call (0 if no time is left in the current phase)
+	 */
+	double get_slice(double per_call_timeout) const;
+	/*!
+	 * @return whether no time is left in the current phase
+	 */
+	bool expired() const;
+	/*!
+	 * @return whether a total budget was set
+	 */
+	bool is_limited() const;
+
+private:
+	using clock = std::chrono::steady_clock;
+	double seconds;
+	double adder_phase_share;
+	clock::time_point start_time;
+	/*!
+	 * end of the total budget
+	 */
+	clock::time_point deadline = clock::time_point::max();
+	/*!
+	 * end of the current phase (never after this->deadline)
+	 */
+	clock::time_point phase_deadline = clock::time_point::max();
+	/*!
+	 * @return now + seconds (or time_point::max() if seconds is too large to be represented)
+	 */
+	static clock::time_point after(double seconds);
+	/*!
+	 * @return the number of seconds until t (or 0 if t has passed)
+	 */
+	static double seconds_until(clock::time_point t);
+};
+
+#endif //SATSCM_TIME_BUDGET_H
@@ -0,0 +1,210 @@
+//
+// Created by nfiege on 11/21/22.
+//
+
+#ifndef SATSCM_VARIABLE_MAP_H
+#define SATSCM_VARIABLE_MAP_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+/*!
+ * converts keys of a variable_map (int, enum, std::pair or std::tuple of them) to index arrays and back
+ */
+template <typename Key>
+struct variable_map_key {
+	static constexpr size_t dimensions = 1;
+	static std::array<int, dimensions> to_indices(const Key &key) {
+		return {static_cast<int>(key)};
+	}
+	static Key from_indices(const std::array<int, dimensions> &indices) {
+		return static_cast<Key>(indices[0]);
+	}
+};
+
+template <typename A, typename B>
+struct variable_map_key<std::pair<A, B>> {
+	static constexpr size_t dimensions = 2;
+	static std::array<int, dimensions> to_indices(const std::pair<A, B> &key) {
+		return {static_cast<int>(key.first), static_cast<int>(key.second)};
+	}
+	static std::pair<A, B> from_indices(const std::array<int, dimensions> &indices) {
+		return {static_cast<A>(indices[0]), static_cast<B>(indices[1])};
+	}
+};
+
+template <typename... Ts>
+struct variable_map_key<std::tuple<Ts...>> {
+	static constexpr size_t dimensions = sizeof...(Ts);
+	static std::array<int, dimensions> to_indices(const std::tuple<Ts...> &key) {
+		return std::apply([](const auto &... k) { return std::array<int, dimensions>{static_cast<int>(k)...}; }, key);
+	}
+	static std::tuple<Ts...> from_indices(const std::array<int, dimensions> &indices) {
+		return from_indices(indices, std::index_sequence_for<Ts...>());
+	}
+private:
+	template <size_t... I>
+	static std::tuple<Ts...> from_indices(const std::array<int, dimensions> &indices, std::index_sequence<I...>) {
+		return std::tuple<Ts...>(static_cast<Ts>(indices[I])...);
+	}
+};
+
+/*!
+ * replacement for std::map<Key, int> that maps small non-negative keys to SAT variable indices
+ * the keys are int, enum, std::pair or std::tuple of them, e.g., < node idx, left/right, bit >
+ * the values are stored in a flat row-major array, so each lookup is a bit of index arithmetic instead of a tree search
+ * and all variables of one node are stored next to each other
+ * 0 marks a missing entry (variable indices start at 1)
+ * iteration visits the entries in the same order as std::map
+ */
+template <typename Key>
+class variable_map {
+public:
+	static constexpr size_t dimensions = variable_map_key<Key>::dimensions;
+	using indices_type = std::array<int, dimensions>;
+	using key_type = Key;
+	using value_type = std::pair<Key, int>;
+
+	class iterator {
+	public:
+		iterator(const variable_map *map, size_t position) : map(map), position(position) {
+			this->skip_missing();
+		}
+		const value_type &operator*() {
+			this->current = {variable_map_key<Key>::from_indices(this->map->get_indices(this->position)), this->map->values[this->position]};
+			return this->current;
+		}
+		const value_type *operator->() {
+			return &**this;
+		}
+		iterator &operator++() {
+			this->position++;
+			this->skip_missing();
+			return *this;
+		}
+		bool operator==(const iterator &other) const {
+			return this->position == other.position;
+		}
+		bool operator!=(const iterator &other) const {
+			return this->position != other.position;
+		}
+	private:
+		const variable_map *map;
+		size_t position;
+		value_type current;
+		void skip_missing() {
+			while (this->position < this->map->values.size() and this->map->values[this->position] == 0) this->position++;
+		}
+	};
+
+	/*!
+	 * @return the variable idx for key (an entry for key is created if it does not exist yet)
+	 */
+	int &operator[](const Key &key) {
+		auto indices = variable_map_key<Key>::to_indices(key);
+		bool fits = true;
+		for (size_t d = 0; d < dimensions; d++) {
+			if (indices[d] < 0) throw std::out_of_range("variable_map: negative key");
+			fits = fits and indices[d] < this->extents[d];
+		}
+		if (!fits) this->grow(indices);
+		return this->values[this->get_position(indices)];
+	}
+	/*!
+	 * @return the variable idx for key (throws std::out_of_range if it does not exist)
+	 */
+	int at(const Key &key) const {
+		auto position = this->find_position(variable_map_key<Key>::to_indices(key));
+		if (position == this->values.size()) throw std::out_of_range("variable_map::at");
+		return this->values[position];
+	}
+	iterator find(const Key &key) const {
+		return iterator(this, this->find_position(variable_map_key<Key>::to_indices(key)));
+	}
+	iterator begin() const {
+		return iterator(this, 0);
+	}
+	iterator end() const {
+		return iterator(this, this->values.size());
+	}
+	/*!
+	 * @return number of entries (linear in the allocated size)
+	 */
+	size_t size() const {
+		size_t result = 0;
+		for (auto &v : this->values) {
+			if (v != 0) result++;
+		}
+		return result;
+	}
+	bool empty() const {
+		return this->begin() == this->end();
+	}
+	/*!
+	 * remove all entries but keep the memory for the next problem
+	 */
+	void clear() {
+		std::fill(this->values.begin(), this->values.end(), 0);
+	}
+
+private:
+	indices_type extents{};
+	std::vector<int> values;
+
+	size_t get_position(const indices_type &indices) const {
+		size_t position = 0;
+		for (size_t d = 0; d < dimensions; d++) {
+			position = position * this->extents[d] + indices[d];
+		}
+		return position;
+	}
+	indices_type get_indices(size_t position) const {
+		indices_type indices;
+		for (size_t d = dimensions; d-- > 0;) {
+			indices[d] = (int)(position % this->extents[d]);
+			position /= this->extents[d];
+		}
+		return indices;
+	}
+	/*!
+	 * @return the position of the entry or this->values.size() if it does not exist
+	 */
+	size_t find_position(const indices_type &indices) const {
+		for (size_t d = 0; d < dimensions; d++) {
+			if (indices[d] < 0 or indices[d] >= this->extents[d]) return this->values.size();
+		}
+		auto position = this->get_position(indices);
+		return this->values[position] == 0 ? this->values.size() : position;
+	}
+	/*!
+	 * enlarge the array such that it contains indices
+	 * dimensions that are too small are doubled to keep the number of reallocations low
+	 */
+	void grow(const indices_type &indices) {
+		auto new_extents = this->extents;
+		size_t new_size = 1;
+		for (size_t d = 0; d < dimensions; d++) {
+			if (indices[d] >= new_extents[d]) new_extents[d] = std::max(indices[d] + 1, 2 * new_extents[d]);
+			new_size *= new_extents[d];
+		}
+		std::vector<int> new_values(new_size, 0);
+		for (size_t position = 0; position < this->values.size(); position++) {
+			if (this->values[position] == 0) continue;
+			auto old_indices = this->get_indices(position);
+			size_t new_position = 0;
+			for (size_t d = 0; d < dimensions; d++) {
+				new_position = new_position * new_extents[d] + old_indices[d];
+			}
+			new_values[new_position] = this->values[position];
+		}
+		this->extents = new_extents;
+		this->values = std::move(new_values);
+	}
+};
+
+#endif //SATSCM_VARIABLE_MAP_H
@@ -0,0 +1,87 @@
+//
+// Created by nfiege on 11/19/22.
+//
+
+#include "work_stealing_pool.h"
+#include <algorithm>
+
+work_stealing_pool::work_stealing_pool(int num_threads) {
+	num_threads = std::max(1, num_threads);
+	for (int i = 0; i < num_threads; i++) {
+		this->queues.emplace_back(std::make_unique<task_queue>());
+	}
+	for (int i = 0; i < num_threads; i++) {
+		this->workers.emplace_back(&work_stealing_pool::run_worker, this, i);
+	}
+}
+
+work_stealing_pool::~work_stealing_pool() {
+	this->wait();
+	{
+		std::lock_guard<std::mutex> lock(this->state_mutex);
+		this->stop = true;
+	}
+	this->task_available.notify_all();
+	for (auto &t : this->workers) {
+		t.join();
+	}
+}
+
+void work_stealing_pool::submit(std::function<void()> task) {
+	auto &queue = this->queues[this->next_queue++ % this->queues.size()];
+	this->pending_tasks++;
+	{
+		std::lock_guard<std::mutex> lock(queue->mutex);
+		queue->tasks.emplace_back(std::move(task));
+	}
+	{
+		// the lock makes sure that no worker misses the notification between checking the queues and going to sleep
+		std::lock_guard<std::mutex> lock(this->state_mutex);
+		this->queued_tasks++;
+	}
+	this->task_available.notify_one();
+}
+
+void work_stealing_pool::wait() {
+	std::unique_lock<std::mutex> lock(this->state_mutex);
+	this->all_done.wait(lock, [this]() { return this->pending_tasks == 0; });
+}
+
+bool work_stealing_pool::pop_task(int worker_idx, std::function<void()> &task) {
+	int num_queues = (int)this->queues.size();
+	for (int i = 0; i < num_queues; i++) {
+		// start with the own queue and then try to steal from the others
+		auto &queue = this->queues[(worker_idx + i) % num_queues];
+		std::lock_guard<std::mutex> lock(queue->mutex);
+		if (queue->tasks.empty()) continue;
+		if (i == 0) {
+			task = std::move(queue->tasks.back());
+			queue->tasks.pop_back();
+		}
+		else {
+			task = std::move(queue->tasks.front());
+			queue->tasks.pop_front();
+		}
+		this->queued_tasks--;
+		return true;
+	}
+	return false;
+}
+
+void work_stealing_pool::run_worker(int worker_idx) {
+	std::function<void()> task;
+	while (true) {
+		if (this->pop_task(worker_idx, task)) {
+			task();
+			task = nullptr;
+			if (--this->pending_tasks == 0) {
+				std::lock_guard<std::mutex> lock(this->state_mutex);
+				this->all_done.notify_all();
+			}
+			continue;
+		}
+		std::unique_lock<std::mutex> lock(this->state_mutex);
+		this->task_available.wait(lock, [this]() { return this->stop or this->queued_tasks > 0; });
+		if (this->stop and this->queued_tasks == 0) return;
+	}
+}
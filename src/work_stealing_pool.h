@@ -0,0 +1,80 @@
+//
+// Created by nfiege on 11/19/22.
+//
+
+#ifndef SATSCM_WORK_STEALING_POOL_H
+#define SATSCM_WORK_STEALING_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*!
+ * thread pool where each worker owns a task queue
+ * new tasks are distributed round-robin over the queues
+ * workers take tasks from the back of their own queue and steal from the front of other queues when theirs is empty
+ */
+class work_stealing_pool {
+public:
+	/*!
+	 * start the workers
+	 * @param num_threads number of worker threads (at least 1)
+	 */
+	explicit work_stealing_pool(int num_threads);
+	/*!
+	 * wait for all tasks and stop the workers
+	 */
+	~work_stealing_pool();
+	work_stealing_pool(const work_stealing_pool &) = delete;
+	work_stealing_pool &operator=(const work_stealing_pool &) = delete;
+	/*!
+	 * add a task (thread-safe)
+	 * tasks must not throw
+	 * @param task the task
+	 */
+	void submit(std::function<void()> task);
+	/*!
+	 * block until all submitted tasks are finished
+	 */
+	void wait();
+
+private:
+	struct task_queue {
+		std::mutex mutex;
+		std::deque<std::function<void()>> tasks;
+	};
+	std::vector<std::unique_ptr<task_queue>> queues;
+	std::vector<std::thread> workers;
+	/*!
+	 * used to put idle workers to sleep and to wake up this->wait()
+	 */
+	std::mutex state_mutex;
+	std::condition_variable task_available;
+	std::condition_variable all_done;
+	/*!
+	 * number of submitted tasks that are not finished yet
+	 */
+	std::atomic<int> pending_tasks = 0;
+	/*!
+	 * number of submitted tasks that are not started yet
+	 */
+	std::atomic<int> queued_tasks = 0;
+	std::atomic<unsigned int> next_queue = 0;
+	bool stop = false;
+	/*!
+	 * main loop of the worker with index worker_idx
+	 */
+	void run_worker(int worker_idx);
+	/*!
+	 * get a task from the own queue or steal one
+	 * @return whether a task was found
+	 */
+	bool pop_task(int worker_idx, std::function<void()> &task);
+};
+
+#endif //SATSCM_WORK_STEALING_POOL_H
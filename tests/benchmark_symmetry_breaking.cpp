@@ -0,0 +1,58 @@
+//
+// Created by nfiege on 12/2/22.
+//
+
+#include <test_util.h>
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+
+/*!
+ * median wall clock time of solving the constants (the UNSAT proofs below the optimum dominate it)
+ * @param C the constants
+ * @param symmetry_breaking whether the symmetry breaking constraints are added
+ * @param repetitions how often the problem is solved
+ * @param num_adders is set to the adder count of the solution
+ * @return the time in seconds
+ */
+static double median_time(const std::vector<int> &C, bool symmetry_breaking, int repetitions, int &num_adders) {
+	std::vector<double> times;
+	for (int i = 0; i < repetitions; i++) {
+		// the constructor also prints something
+		cout_capture capture;
+		auto start_time = std::chrono::steady_clock::now();
+		auto solver = solve_with(C, [&](scm &s) { if (symmetry_breaking) s.use_symmetry_breaking(); });
+		times.emplace_back(std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count());
+		CHECK(solver->solution_is_optimal().first);
+		num_adders = solver->get_adder_bounds().second;
+	}
+	std::sort(times.begin(), times.end());
+	return times[times.size()/2];
+}
+
+int main(int argc, char **argv) {
+	// usage: benchmark_symmetry_breaking [C1 C2 ...] where each problem is given as colon-separated constants
+	std::vector<std::vector<int>> problems;
+	for (int i = 1; i < argc; i++) {
+		std::stringstream arg(argv[i]);
+		std::string c;
+		std::vector<int> C;
+		while (std::getline(arg, c, ':')) C.emplace_back(std::stoi(c));
+		problems.emplace_back(C);
+	}
+	if (problems.empty()) problems = {{11467}, {23, 81}, {3, 5, 13}, {3, 7, 21, 53, 91, 117}, {1721, 3435}};
+	const int repetitions = 3;
+	std::cout << std::left << std::setw(32) << "constants" << std::setw(8) << "#adders" << std::setw(12) << "plain [s]" << std::setw(14) << "symmetry [s]" << "speedup" << std::endl;
+	for (auto &C : problems) {
+		std::string name;
+		for (auto &c : C) name += (name.empty() ? "" : ":") + std::to_string(c);
+		int plain_adders = 0;
+		int symmetry_adders = 0;
+		auto plain = median_time(C, false, repetitions, plain_adders);
+		auto symmetry = median_time(C, true, repetitions, symmetry_adders);
+		// symmetry breaking must not change the optimum
+		CHECK(plain_adders == symmetry_adders);
+		std::cout << std::left << std::setw(32) << name << std::setw(8) << plain_adders << std::setw(12) << plain << std::setw(14) << symmetry << plain / symmetry << std::endl;
+	}
+	return 0;
+}
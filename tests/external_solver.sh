@@ -0,0 +1,34 @@
+#!/bin/sh
+# smoke test for the external solver backend with a stub solver
+# usage: external_solver.sh <satscm executable>
+satscm="$1"
+stub="$(cd "$(dirname "$0")" && pwd)/stub_solver.sh"
+fail() {
+	echo "FAILED: $1"
+	exit 1
+}
+
+# 11 needs 2 adders -> the stub proves that 1 adder is infeasible and the heuristic solution is optimal
+out=$("$satscm" 11 "external:sh $stub unsat" 10 1 1 0 0 0 0 0 -1 0 1 linear 1 2>&1) || fail "satscm exited with an error"
+echo "$out" | grep -q "is proven to be infeasible" || fail "the stub's answer was ignored"
+echo "$out" | grep -q "#adders = 2" || fail "wrong number of adders"
+echo "$out" | grep -q "#Add optimal = 1" || fail "the solution is not reported as optimal"
+
+# a solver that ignores SIGTERM must be killed (with all its children) shortly after the timeout
+STUB_PID_FILE=$(mktemp)
+export STUB_PID_FILE
+start=$(date +%s)
+out=$("$satscm" 11 "external:sh $stub hang" 1 1 1 0 0 0 0 0 -1 0 1 linear 1 2>&1) || fail "satscm exited with an error"
+elapsed=$(($(date +%s) - start))
+[ "$elapsed" -le 10 ] || fail "the hanging solver was stopped after $elapsed seconds"
+echo "$out" | grep -q "ran into timeout" || fail "the timeout was not reported"
+for pid in $(cat "$STUB_PID_FILE"); do
+	# zombies count as stopped (they only wait for init to reap them)
+	state=$(ps -o stat= -p "$pid" 2>/dev/null)
+	case "$state" in
+		""|Z*) ;;
+		*) fail "process $pid of the solver is still running" ;;
+	esac
+done
+rm -f "$STUB_PID_FILE"
+echo "passed"
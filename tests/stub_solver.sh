@@ -0,0 +1,18 @@
+#!/bin/sh
+# stub for an external DIMACS solver
+#   unsat: read the problem and report that it is infeasible
+#   hang: ignore SIGTERM and never answer (the pids of the stub and its child are written to $STUB_PID_FILE)
+case "$1" in
+	unsat)
+		cat > /dev/null
+		echo "s UNSATISFIABLE"
+		exit 20
+		;;
+	hang)
+		trap '' TERM
+		sleep 300 &
+		echo "$$ $!" > "$STUB_PID_FILE"
+		wait
+		;;
+esac
+exit 0
@@ -0,0 +1,21 @@
+//
+// Created by nfiege on 12/2/22.
+//
+
+#include <test_util.h>
+
+int main() {
+	// top-down and binary search must find the same optimum as the bottom-up search
+	std::vector<std::function<void(scm &)>> variants;
+	for (auto strategy : {scm::adder_search::top_down_adder_search, scm::adder_search::binary_adder_search}) {
+		variants.emplace_back([strategy](scm &s) {
+			s.use_heuristic_start_solution();
+			s.set_adder_search(strategy);
+		});
+		// without an upper bound it falls back to the bottom-up search
+		variants.emplace_back([strategy](scm &s) { s.set_adder_search(strategy); });
+	}
+	check_same_optimum(variants);
+	std::cout << "passed" << std::endl;
+	return 0;
+}
@@ -0,0 +1,90 @@
+//
+// Created by nfiege on 12/2/22.
+//
+
+#include <test_util.h>
+#include <batch.h>
+#include <scm_factory.h>
+#include <work_stealing_pool.h>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <stdexcept>
+#include <thread>
+
+/*!
+ * @return seconds that the pool needs for tasks sleeping for task_ms milliseconds
+ */
+static double run_sleeping_tasks(int threads, int tasks, int task_ms) {
+	auto start_time = std::chrono::steady_clock::now();
+	std::atomic<int> finished = 0;
+	{
+		work_stealing_pool pool(threads);
+		for (int i = 0; i < tasks; i++) {
+			pool.submit([&]() {
+				std::this_thread::sleep_for(std::chrono::milliseconds(task_ms));
+				finished++;
+			});
+		}
+		pool.wait();
+		CHECK(finished == tasks);
+	}
+	return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_time).count() / 1000.0;
+}
+
+int main() {
+	// all tasks run, also the ones submitted by other tasks
+	{
+		std::atomic<int> counter = 0;
+		std::atomic<int> nested_counter = 0;
+		work_stealing_pool pool(3);
+		for (int i = 0; i < 100; i++) {
+			pool.submit([&, i]() {
+				counter++;
+				if (i < 10) pool.submit([&]() { nested_counter++; });
+			});
+		}
+		pool.wait();
+		CHECK(counter == 100);
+		CHECK(nested_counter == 10);
+	}
+	// waiting tasks are spread over all workers (they sleep, so this doesn't need several cores)
+	auto serial = run_sleeping_tasks(1, 8, 100);
+	auto parallel = run_sleeping_tasks(4, 8, 100);
+	CHECK(serial >= 0.8);
+	CHECK(parallel < 0.6);
+
+	// one broken problem doesn't affect the others
+	std::stringstream input;
+	input << "# comment" << std::endl;
+	input << "11" << std::endl;
+	input << std::endl;
+	input << "not:a:constant" << std::endl;
+	input << "13" << std::endl;
+	input << "7 5" << std::endl;
+	std::stringstream output;
+	auto num_solved = solve_batch(input, output, 2, 60, [](const std::vector<int> &C, int timeout) {
+		if (C.front() == 13) throw std::runtime_error("backend failed");
+		return create_scm(get_available_backends().front(), C, timeout, true, 1, false, false);
+	});
+	CHECK(num_solved == 2);
+	std::map<int, std::string> records;
+	std::string line;
+	while (std::getline(output, line)) {
+		if (line.empty() or line[0] != '{') continue;
+		auto pos = line.find("\"id\":");
+		CHECK(pos != std::string::npos);
+		records[std::stoi(line.substr(pos+5))] = line;
+	}
+	CHECK(records.size() == 4);
+	CHECK(records[0].find("\"constants\":[11]") != std::string::npos);
+	CHECK(records[0].find("\"status\":\"solved\"") != std::string::npos);
+	CHECK(records[1].find("\"status\":\"error\"") != std::string::npos);
+	CHECK(records[1].find("failed to parse") != std::string::npos);
+	CHECK(records[2].find("\"status\":\"error\"") != std::string::npos);
+	CHECK(records[2].find("backend failed") != std::string::npos);
+	CHECK(records[3].find("\"constants\":[7]") != std::string::npos);
+	CHECK(records[3].find("\"status\":\"solved\"") != std::string::npos);
+	std::cout << "passed" << std::endl;
+	return 0;
+}
@@ -0,0 +1,111 @@
+//
+// Created by nfiege on 12/2/22.
+//
+
+#include <test_util.h>
+#include <result_cache.h>
+#include <scm_factory.h>
+#include <filesystem>
+#include <fstream>
+
+/*!
+ * solve a single constant with the first available backend and the given cache
+ * @param min_add passed to scm::set_min_add (<= 0 -> not set)
+ * @return everything the solver printed to std::cout
+ */
+static std::string solve(int c, std::shared_ptr<const result_cache> cache, int min_add, std::pair<int, int> &bounds) {
+	auto solver = create_scm(get_available_backends().front(), {c}, 60, true, 1, false, false);
+	solver->set_result_cache(cache);
+	if (min_add > 0) solver->set_min_add(min_add);
+	cout_capture capture;
+	solver->solve();
+	bounds = solver->get_adder_bounds();
+	return capture.str();
+}
+
+int main() {
+	const std::string directory = "test_cache_directory";
+	std::filesystem::remove_all(directory);
+	auto cache = std::make_shared<const result_cache>(directory);
+	result_cache::entry e;
+	CHECK(!cache->load("a", e));
+
+	// store and load
+	result_cache::entry first;
+	first.graph = "graph with 3 adders";
+	first.num_adders = 3;
+	first.adder_lower_bound = 1;
+	cache->store("a", first);
+	CHECK(cache->load("a", e));
+	CHECK(e.graph == first.graph and e.num_adders == 3 and e.adder_lower_bound == 1 and !e.full_adders_known);
+	CHECK(!e.adders_optimal());
+	CHECK(!cache->load("b", e));
+
+	// a worse graph with a better lower bound -> keep the graph and take the bound
+	result_cache::entry worse;
+	worse.graph = "graph with 4 adders";
+	worse.num_adders = 4;
+	worse.adder_lower_bound = 3;
+	cache->store("a", worse);
+	CHECK(cache->load("a", e));
+	CHECK(e.graph == first.graph and e.num_adders == 3 and e.adder_lower_bound == 3);
+	CHECK(e.adders_optimal());
+
+	// same adder count -> keep the graph with fewer full adders and the best full adder bound
+	result_cache::entry fa_1;
+	fa_1.graph = "graph with 20 full adders";
+	fa_1.num_adders = 3;
+	fa_1.full_adders_known = true;
+	fa_1.full_adders = 20;
+	fa_1.full_adder_lower_bound = 15;
+	cache->store("a", fa_1);
+	result_cache::entry fa_2 = fa_1;
+	fa_2.graph = "graph with 25 full adders";
+	fa_2.full_adders = 25;
+	fa_2.full_adder_lower_bound = 18;
+	cache->store("a", fa_2);
+	CHECK(cache->load("a", e));
+	CHECK(e.graph == fa_1.graph and e.full_adders_known and e.full_adders == 20 and e.full_adder_lower_bound == 18);
+	CHECK(e.adder_lower_bound == 3);
+	CHECK(!e.full_adders_optimal());
+	fa_2.graph = "graph with 18 full adders";
+	fa_2.full_adders = 18;
+	cache->store("a", fa_2);
+	CHECK(cache->load("a", e));
+	CHECK(e.graph == fa_2.graph and e.full_adders_optimal());
+	// a better adder count replaces the full adder information
+	result_cache::entry better;
+	better.graph = "graph with 2 adders";
+	better.num_adders = 2;
+	cache->store("a", better);
+	CHECK(cache->load("a", e));
+	CHECK(e.graph == better.graph and e.num_adders == 2 and !e.full_adders_known and e.adders_optimal());
+
+	// corrupt files are cache misses
+	for (auto &it : std::filesystem::directory_iterator(directory)) {
+		if (it.path().extension() != ".txt") continue;
+		std::ofstream f(it.path(), std::ios::trunc);
+		f << "key a" << std::endl << "graph x" << std::endl << "adders many" << std::endl;
+	}
+	CHECK(!cache->load("a", e));
+
+	// a minimum adder count is no proof -> the cached result is continued instead of being reused
+	std::filesystem::remove_all(directory);
+	cache = std::make_shared<const result_cache>(directory);
+	std::pair<int, int> bounds;
+	auto output = solve(11, cache, 2, bounds);
+	CHECK(bounds.second == 2);
+	output = solve(11, cache, 0, bounds);
+	CHECK(output.find("continuing cached result") != std::string::npos);
+	CHECK(bounds.first == 2 and bounds.second == 2);
+	// now it is proven
+	output = solve(11, cache, 0, bounds);
+	CHECK(output.find("in result cache") != std::string::npos);
+	CHECK(bounds.first == 2 and bounds.second == 2);
+	// other constants don't share the entry
+	output = solve(13, cache, 0, bounds);
+	CHECK(output.find("in result cache") == std::string::npos);
+	std::filesystem::remove_all(directory);
+	std::cout << "passed" << std::endl;
+	return 0;
+}
@@ -0,0 +1,102 @@
+//
+// Created by nfiege on 12/2/22.
+//
+
+#include <test_util.h>
+#include <clause_exchange.h>
+#include <atomic>
+#include <thread>
+
+int main() {
+	// clauses of the other participants arrive in order, the own and the long ones don't
+	{
+		clause_exchange exchange(3, 16);
+		auto first = exchange.join();
+		auto second = exchange.join();
+		CHECK(first != second);
+		CHECK(exchange.get_max_clause_size() == 3);
+		std::vector<int> c1 = {1, -2};
+		std::vector<int> c2 = {3, 4, -5};
+		std::vector<int> too_long = {1, 2, 3, 4};
+		exchange.export_clause(first, c1.data(), (int)c1.size());
+		exchange.export_clause(first, too_long.data(), (int)too_long.size());
+		exchange.export_clause(first, c2.data(), 0);
+		exchange.export_clause(first, c2.data(), (int)c2.size());
+		uint64_t first_position = 0;
+		uint64_t second_position = 0;
+		CHECK(exchange.num_pending(second_position) == 2);
+		std::vector<int> clauses;
+		CHECK(exchange.import_clauses(second, second_position, clauses, 100) == 2);
+		CHECK((clauses == std::vector<int>{1, -2, 0, 3, 4, -5, 0}));
+		CHECK(exchange.num_pending(second_position) == 0);
+		clauses.clear();
+		CHECK(exchange.import_clauses(second, second_position, clauses, 100) == 0);
+		CHECK(exchange.import_clauses(first, first_position, clauses, 100) == 0);
+		CHECK(clauses.empty() and exchange.num_pending(first_position) == 0);
+	}
+	// slow participants only get the newest clauses
+	{
+		clause_exchange exchange(2, 4);
+		auto writer = exchange.join();
+		auto reader = exchange.join();
+		for (int i = 1; i <= 10; i++) {
+			std::vector<int> c = {i, -i};
+			exchange.export_clause(writer, c.data(), (int)c.size());
+		}
+		uint64_t position = 0;
+		std::vector<int> clauses;
+		CHECK(exchange.import_clauses(reader, position, clauses, 100) == 4);
+		CHECK((clauses == std::vector<int>{7, -7, 0, 8, -8, 0, 9, -9, 0, 10, -10, 0}));
+		position = 0;
+		clauses.clear();
+		CHECK(exchange.import_clauses(reader, position, clauses, 2) == 2);
+		CHECK((clauses == std::vector<int>{9, -9, 0, 10, -10, 0}));
+	}
+	// concurrent writers and readers never see torn clauses
+	{
+		const int num_writers = 3;
+		const int num_readers = 2;
+		const int clauses_per_writer = 20000;
+		clause_exchange exchange(3, 64);
+		std::atomic<int> running_writers = num_writers;
+		std::atomic<bool> failed = false;
+		std::atomic<long long> num_imported = 0;
+		std::vector<std::thread> threads;
+		for (int w = 0; w < num_writers; w++) {
+			threads.emplace_back([&, w]() {
+				auto id = exchange.join();
+				for (int i = 1; i <= clauses_per_writer; i++) {
+					// the last literal is a checksum of the others
+					std::vector<int> c = {w+1, i, -(w+1+i)};
+					exchange.export_clause(id, c.data(), (int)c.size());
+				}
+				running_writers--;
+			});
+		}
+		for (int r = 0; r < num_readers; r++) {
+			threads.emplace_back([&]() {
+				auto id = exchange.join();
+				uint64_t position = 0;
+				std::vector<int> last_index(num_writers+1, 0);
+				std::vector<int> clauses;
+				while (running_writers > 0 or exchange.num_pending(position) > 0) {
+					clauses.clear();
+					num_imported += exchange.import_clauses(id, position, clauses, 1000);
+					for (size_t i = 0; i < clauses.size(); i += 4) {
+						auto w = clauses[i];
+						auto index = clauses[i+1];
+						bool consistent = w >= 1 and w <= num_writers and clauses[i+2] == -(w+index) and clauses[i+3] == 0;
+						// clauses of one writer are imported in the order they were exported
+						if (!consistent or index <= last_index[w]) failed = true;
+						else last_index[w] = index;
+					}
+				}
+			});
+		}
+		for (auto &t : threads) t.join();
+		CHECK(!failed);
+		CHECK(num_imported > 0);
+	}
+	std::cout << "passed" << std::endl;
+	return 0;
+}
@@ -0,0 +1,99 @@
+//
+// Created by nfiege on 12/2/22.
+//
+
+#include <test_util.h>
+#include <cnf_reader.h>
+#include <cnf_writer.h>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+
+int main() {
+	std::mt19937 rng(7);
+	// random clauses with literals that need one to four bytes in the binary encoding
+	const int num_variables = 3000000;
+	std::vector<std::vector<int>> clauses;
+	for (int i = 0; i < 2000; i++) {
+		std::vector<int> clause;
+		int length = 1 + (int)(rng() % 8);
+		for (int j = 0; j < length; j++) {
+			int max_variable = std::vector<int>{50, 8000, 1000000, num_variables}[rng() % 4];
+			int variable = 1 + (int)(rng() % max_variable);
+			clause.emplace_back(rng() % 2 == 0 ? variable : -variable);
+		}
+		clauses.emplace_back(clause);
+	}
+	auto flatten = [](const std::vector<std::vector<int>> &c, size_t num_clauses, const std::vector<int> &units) {
+		std::vector<int> result;
+		for (size_t i = 0; i < num_clauses; i++) {
+			result.insert(result.end(), c[i].begin(), c[i].end());
+			result.emplace_back(0);
+		}
+		for (auto &u : units) {
+			result.emplace_back(u);
+			result.emplace_back(0);
+		}
+		return result;
+	};
+	for (auto extension : {"cnf", "bcnf", "cnf.gz", "bcnf.gz", "cnf.xz", "bcnf.xz"}) {
+		cnf_writer::format f;
+		try {
+			f = cnf_writer::parse_format(extension);
+		}
+		catch (std::runtime_error &) {
+			// compression that is not part of this build
+			continue;
+		}
+		CHECK(cnf_writer::get_extension(f) == extension);
+		std::string first_file = std::string("test_cnf_1.") + extension;
+		std::string second_file = std::string("test_cnf_2.") + extension;
+		CHECK(cnf_reader::strip_extension(first_file) == "test_cnf_1");
+		{
+			// two files of a growing problem, the unit clauses only go into one of them
+			cnf_writer writer(f);
+			for (size_t i = 0; i < clauses.size()/2; i++) writer.add_clause(clauses[i].data(), (int)clauses[i].size());
+			writer.write_file(first_file, num_variables, {5, -7});
+			for (size_t i = clauses.size()/2; i < clauses.size(); i++) writer.add_clause(clauses[i].data(), (int)clauses[i].size());
+			writer.write_file(second_file, num_variables, {});
+		}
+		int read_num_variables = 0;
+		std::vector<int> read_clauses;
+		cnf_reader::read_file(first_file, read_num_variables, read_clauses);
+		CHECK(read_num_variables == num_variables);
+		CHECK(read_clauses == flatten(clauses, clauses.size()/2, {5, -7}));
+		cnf_reader::read_file(second_file, read_num_variables, read_clauses);
+		CHECK(read_num_variables == num_variables);
+		CHECK(read_clauses == flatten(clauses, clauses.size(), {}));
+		std::remove(first_file.c_str());
+		std::remove(second_file.c_str());
+	}
+	// errors
+	CHECK(cnf_reader::strip_extension("problem.txt").empty());
+	bool failed = false;
+	try {
+		cnf_writer::parse_format("txt");
+	}
+	catch (std::runtime_error &) {
+		failed = true;
+	}
+	CHECK(failed);
+	{
+		std::ofstream f("test_cnf_broken.cnf", std::ios::trunc);
+		f << "p cnf 3 2" << std::endl << "1 -2 0" << std::endl << "x 0" << std::endl;
+	}
+	failed = false;
+	try {
+		int read_num_variables = 0;
+		std::vector<int> read_clauses;
+		cnf_reader::read_file("test_cnf_broken.cnf", read_num_variables, read_clauses);
+	}
+	catch (std::runtime_error &) {
+		failed = true;
+	}
+	CHECK(failed);
+	std::remove("test_cnf_broken.cnf");
+	std::cout << "passed" << std::endl;
+	return 0;
+}
@@ -0,0 +1,61 @@
+//
+// Created by nfiege on 12/2/22.
+//
+
+#include <test_util.h>
+#include <adder_graph.h>
+#include <stdexcept>
+
+/*!
+ * @return number of non-zero digits in the CSD representation of x
+ */
+static int csd_digits(int64_t x) {
+	int digits = 0;
+	while (x != 0) {
+		if (x & 1) {
+			x -= (x & 3) == 3 ? -1 : 1;
+			digits++;
+		}
+		x >>= 1;
+	}
+	return digits;
+}
+
+int main() {
+	// single constants: valid graphs that are never worse than the CSD representation
+	for (int c = 3; c < 1024; c += 2) {
+		int max_bits = 1;
+		while ((1 << max_bits) <= c) max_bits++;
+		max_bits++;
+		auto graph = create_heuristic_adder_graph({c}, max_bits, max_bits-1);
+		CHECK(!graph.empty());
+		CHECK(graph.back().value == c);
+		CHECK((int)graph.size() <= csd_digits(c)-1);
+		CHECK(is_valid_adder_graph(graph, {c}, max_bits, max_bits-1));
+	}
+	// constants with one adder
+	CHECK(create_heuristic_adder_graph({3}, 3, 2).size() == 1);
+	CHECK(create_heuristic_adder_graph({7}, 4, 3).size() == 1);
+	// even and negative constants are normalized
+	CHECK(is_valid_adder_graph(create_heuristic_adder_graph({-44}, 7, 6), {-44}, 7, 6));
+	CHECK(create_heuristic_adder_graph({0, 1, 8}, 5, 4).empty());
+	// multiple constants share nodes
+	std::vector<int> C = {3, 7, 21, 53, 91, 117};
+	auto graph = create_heuristic_adder_graph(C, 8, 7);
+	CHECK(is_valid_adder_graph(graph, C, 8, 7));
+	CHECK(graph.size() < C.size() * 2);
+	// a small shift limit is respected
+	graph = create_heuristic_adder_graph({11467}, 15, 6);
+	CHECK(is_valid_adder_graph(graph, {11467}, 15, 6));
+	// and reported if it is too small for the constant
+	bool failed = false;
+	try {
+		create_heuristic_adder_graph({11467}, 15, 1);
+	}
+	catch (std::runtime_error &) {
+		failed = true;
+	}
+	CHECK(failed);
+	std::cout << "passed" << std::endl;
+	return 0;
+}
@@ -0,0 +1,31 @@
+//
+// Created by nfiege on 12/2/22.
+//
+
+#include <test_util.h>
+
+int main() {
+	// the restricted pass only tries the adder counts earlier -> same optimum as the plain search
+	std::vector<std::function<void(scm &)>> variants;
+	for (int max_shift : {1, 2, 3}) {
+		variants.emplace_back([max_shift](scm &s) { s.use_restricted_domain_pass(max_shift); });
+	}
+	// also together with the other search strategies
+	variants.emplace_back([](scm &s) {
+		s.use_restricted_domain_pass(2);
+		s.use_heuristic_start_solution();
+		s.set_adder_search(scm::adder_search::binary_adder_search);
+	});
+	check_same_optimum(variants);
+	// make sure that the solution of the restricted pass is used at all
+	{
+		auto solver = create_scm(get_available_backends().front(), {83}, 120, true, 1, false, false);
+		solver->use_restricted_domain_pass(2);
+		cout_capture capture;
+		solver->solve();
+		CHECK(capture.str().find("restricted domain pass found solution") != std::string::npos);
+		CHECK(solver->solution_is_optimal().first and solver->get_adder_bounds().second == 3);
+	}
+	std::cout << "passed" << std::endl;
+	return 0;
+}
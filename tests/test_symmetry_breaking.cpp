@@ -0,0 +1,12 @@
+//
+// Created by nfiege on 12/2/22.
+//
+
+#include <test_util.h>
+
+int main() {
+	// symmetry breaking only removes equivalent solutions -> same optimum as the plain search
+	check_same_optimum({[](scm &s) { s.use_symmetry_breaking(); }});
+	std::cout << "passed" << std::endl;
+	return 0;
+}
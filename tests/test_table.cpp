@@ -0,0 +1,86 @@
+//
+// Created by nfiege on 12/2/22.
+//
+
+#include <test_util.h>
+#include <adder_graph_table.h>
+#include <scm_factory.h>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+
+/*!
+ * solve a single constant with the first available backend
+ * @return the solver after this->solve()
+ */
+static std::unique_ptr<scm> solve(int c, std::shared_ptr<const adder_graph_table> table, std::string &output) {
+	auto solver = create_scm(get_available_backends().front(), {c}, 60, true, 1, false, false);
+	if (table != nullptr) solver->set_adder_graph_table(table);
+	cout_capture capture;
+	solver->solve();
+	output = capture.str();
+	return solver;
+}
+
+int main() {
+	const std::string filename = "test_table.bin";
+	std::string output;
+	// reference solutions from the SAT search
+	auto reference_11 = solve(11, nullptr, output);
+	auto reference_13 = solve(13, nullptr, output);
+	CHECK(reference_11->get_adder_bounds().second == 2);
+	std::map<int64_t, adder_graph_table::entry> entries;
+	entries[11] = {2, true, false, reference_11->get_adder_graph_description()};
+	// not proven to be optimal
+	entries[13] = {2, false, false, reference_13->get_adder_graph_description()};
+	// even constants and constants outside the table are skipped
+	entries[14] = entries[11];
+	entries[33] = entries[11];
+	adder_graph_table::write(filename, 5, 0, entries);
+
+	auto table = std::make_shared<const adder_graph_table>(filename);
+	CHECK(table->get_max_bits() == 5);
+	CHECK(table->get_flags() == 0);
+	adder_graph_table::entry e;
+	CHECK(table->lookup(11, e));
+	CHECK(e.num_adders == 2 and e.adders_optimal and !e.full_adders_optimal);
+	CHECK(e.graph == entries[11].graph);
+	CHECK(table->lookup(13, e) and !e.adders_optimal);
+	CHECK(!table->lookup(15, e));
+	CHECK(!table->lookup(14, e));
+	CHECK(!table->lookup(33, e));
+	CHECK(!table->lookup(-11, e));
+
+	// optimal entries replace the SAT search
+	auto solver = solve(11, table, output);
+	CHECK(output.find("in adder graph table") != std::string::npos);
+	CHECK(solver->get_adder_graph_description() == entries[11].graph);
+	CHECK(solver->solution_is_optimal().first);
+	// the others are still solved
+	solver = solve(13, table, output);
+	CHECK(output.find("in adder graph table") == std::string::npos);
+	CHECK(solver->get_adder_bounds().second == 2);
+	// tables that were generated with other settings are ignored
+	adder_graph_table::write(filename, 5, adder_graph_table::node_output_shift, entries);
+	table = std::make_shared<const adder_graph_table>(filename);
+	solver = solve(11, table, output);
+	CHECK(output.find("in adder graph table") == std::string::npos);
+	CHECK(solver->get_adder_bounds().second == 2);
+
+	// broken files are rejected
+	{
+		std::ofstream f(filename, std::ios::trunc);
+		f << "not a table";
+	}
+	bool failed = false;
+	try {
+		adder_graph_table broken(filename);
+	}
+	catch (std::runtime_error &) {
+		failed = true;
+	}
+	CHECK(failed);
+	std::remove(filename.c_str());
+	std::cout << "passed" << std::endl;
+	return 0;
+}
@@ -0,0 +1,71 @@
+//
+// Created by nfiege on 12/2/22.
+//
+
+#include <test_util.h>
+#include <time_budget.h>
+#include <chrono>
+#include <thread>
+
+static void sleep_seconds(double seconds) {
+	std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+}
+
+int main() {
+	// without a total budget only the per-call timeout and the full adder phase limit apply
+	{
+		time_budget budget;
+		budget.start();
+		CHECK(!budget.is_limited());
+		CHECK(budget.get_slice(42.0) == 42.0);
+		budget.reserve_full_adder_phase();
+		CHECK(budget.get_slice(42.0) == 42.0 and !budget.expired());
+		budget.start_full_adder_phase(0.1);
+		CHECK(budget.get_slice(42.0) <= 0.1 and budget.get_slice(42.0) > 0.05);
+		sleep_seconds(0.15);
+		CHECK(budget.expired() and budget.get_slice(42.0) == 0.0);
+	}
+	// the adder count phase gets its share, the full adder phase gets the rest
+	{
+		time_budget budget(1.0, 0.4);
+		budget.start();
+		CHECK(budget.is_limited());
+		CHECK(budget.get_slice(0.01) == 0.01);
+		CHECK(budget.get_slice(42.0) <= 1.0 and budget.get_slice(42.0) > 0.9);
+		budget.reserve_full_adder_phase();
+		CHECK(budget.get_slice(42.0) <= 0.4 and budget.get_slice(42.0) > 0.3);
+		sleep_seconds(0.45);
+		CHECK(budget.expired() and budget.get_slice(42.0) == 0.0);
+		budget.start_full_adder_phase(42.0);
+		CHECK(!budget.expired());
+		CHECK(budget.get_slice(42.0) <= 0.55 and budget.get_slice(42.0) > 0.45);
+		// the phase limit also applies with a total budget
+		budget.start_full_adder_phase(0.1);
+		CHECK(budget.get_slice(42.0) <= 0.1);
+		sleep_seconds(0.6);
+		budget.start_full_adder_phase(42.0);
+		CHECK(budget.expired());
+	}
+	// huge budgets don't overflow
+	{
+		time_budget budget(1e12);
+		budget.start();
+		CHECK(!budget.expired() and budget.get_slice(5.0) == 5.0);
+	}
+	// the whole solve run respects the budget and keeps the best solution
+	{
+		std::vector<int> C = {12345, 23457, 34567, 45679, 56789};
+		auto start_time = std::chrono::steady_clock::now();
+		auto solver = solve_with(C, [](scm &s) {
+			s.also_minimize_full_adders();
+			s.use_heuristic_start_solution();
+			s.set_time_budget(1.0);
+		});
+		auto elapsed_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+		CHECK(elapsed_time < 5.0);
+		CHECK(solver->get_adder_bounds().second > 0);
+		CHECK(is_valid_adder_graph(solver->get_adder_graph(), C, 0, 31));
+	}
+	std::cout << "passed" << std::endl;
+	return 0;
+}
@@ -0,0 +1,124 @@
+//
+// Created by nfiege on 12/2/22.
+//
+
+#ifndef SATSCM_TEST_UTIL_H
+#define SATSCM_TEST_UTIL_H
+
+#include <adder_graph.h>
+#include <scm_factory.h>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/*!
+ * stop the test with an error if the condition does not hold
+ */
+#define CHECK(condition) do { \
+	if (!(condition)) { \
+		std::cerr << __FILE__ << ":" << __LINE__ << ": check failed: " << #condition << std::endl; \
+		std::exit(1); \
+	} \
+} while (false)
+
+/*!
+ * check that each node computes its value from earlier nodes within the limits and that all constants are computed
+ * @param graph the adder graph
+ * @param C the constants
+ * @param max_bits all shifted inputs and node outputs must be smaller than 2^max_bits (<= 0 -> no limit)
+ * @param max_shift maximum left shift
+ * @return whether the graph is valid
+ */
+inline bool is_valid_adder_graph(const std::vector<adder_graph_node> &graph, const std::vector<int> &C, int max_bits, int max_shift) {
+	std::vector<int64_t> values = {1};
+	auto in_range = [&](int64_t x) { return max_bits <= 0 or std::abs(x) < (((int64_t)1) << max_bits); };
+	for (auto &node : graph) {
+		if (node.left_input < 0 or node.left_input >= (int)values.size()) return false;
+		if (node.right_input < 0 or node.right_input >= (int)values.size()) return false;
+		if (node.shift < 0 or node.shift > max_shift) return false;
+		auto l = values[node.left_input] * (((int64_t)1) << node.shift);
+		auto r = values[node.right_input];
+		if (!in_range(l)) return false;
+		int64_t sum;
+		if (node.negate_select == 1) sum = node.subtract == 1 ? l - r : l + r;
+		else sum = node.subtract == 1 ? r - l : r + l;
+		if (!in_range(sum)) return false;
+		auto divisor = ((int64_t)1) << node.post_adder_shift;
+		if (sum % divisor != 0 or sum / divisor != node.value) return false;
+		values.emplace_back(node.value);
+	}
+	std::set<int64_t> computed(values.begin(), values.end());
+	for (auto &c : C) {
+		int64_t t = std::abs((int64_t)c);
+		if (t == 0) continue;
+		while ((t & 1) == 0) t >>= 1;
+		if (computed.find(t) == computed.end() and computed.find(-t) == computed.end()) return false;
+	}
+	return true;
+}
+
+/*!
+ * collects everything that is written to std::cout while it exists
+ */
+class cout_capture {
+public:
+	cout_capture() : old_buffer(std::cout.rdbuf(this->buffer.rdbuf())) {}
+	~cout_capture() { std::cout.rdbuf(this->old_buffer); }
+	std::string str() const { return this->buffer.str(); }
+
+private:
+	std::stringstream buffer;
+	std::streambuf *old_buffer;
+};
+
+/*!
+ * solve constants with the first available backend (the solver output is discarded)
+ * @param C the constants
+ * @param configure is called before scm::solve() to change the settings
+ * @return the solver after scm::solve()
+ */
+inline std::unique_ptr<scm> solve_with(const std::vector<int> &C, const std::function<void(scm &)> &configure) {
+	auto solver = create_scm(get_available_backends().front(), C, 120, true, 1, false, false);
+	configure(*solver);
+	cout_capture capture;
+	solver->solve();
+	return solver;
+}
+
+/*!
+ * solve a set of reference problems with the default settings and check that all variants find the same optimum
+ * the problems are solved once for the adder count and once for the full adder count (smaller problems)
+ * @param variants are called before scm::solve() to change the settings of each variant
+ */
+inline void check_same_optimum(const std::vector<std::function<void(scm &)>> &variants) {
+	std::vector<std::vector<int>> problems = {{11}, {45}, {83}, {7, 21}, {3, 5, 13}, {23, 81}, {11467}, {3, 7, 21, 53, 91, 117}};
+	for (auto &C : problems) {
+		auto plain = solve_with(C, [](scm &) {});
+		CHECK(plain->solution_is_optimal().first);
+		for (auto &configure : variants) {
+			auto variant = solve_with(C, configure);
+			CHECK(variant->solution_is_optimal() == plain->solution_is_optimal());
+			CHECK(variant->get_adder_bounds().second == plain->get_adder_bounds().second);
+			CHECK(is_valid_adder_graph(variant->get_adder_graph(), C, 0, 31));
+		}
+	}
+	for (auto &C : std::vector<std::vector<int>>{{11}, {45}, {7, 21}}) {
+		auto plain = solve_with(C, [](scm &s) { s.also_minimize_full_adders(); });
+		CHECK(plain->solution_is_optimal().first and plain->solution_is_optimal().second);
+		for (auto &configure : variants) {
+			auto variant = solve_with(C, [&](scm &s) { s.also_minimize_full_adders(); configure(s); });
+			CHECK(variant->solution_is_optimal() == plain->solution_is_optimal());
+			CHECK(variant->get_adder_bounds().second == plain->get_adder_bounds().second);
+			CHECK(variant->get_full_adder_bounds().second == plain->get_full_adder_bounds().second);
+			CHECK(is_valid_adder_graph(variant->get_adder_graph(), C, 0, 31));
+		}
+	}
+}
+
+#endif //SATSCM_TEST_UTIL_H
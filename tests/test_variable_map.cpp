@@ -0,0 +1,104 @@
+//
+// Created by nfiege on 12/2/22.
+//
+
+#include <test_util.h>
+#include <variable_map.h>
+#include <map>
+#include <random>
+#include <stdexcept>
+
+enum direction {
+	left, right
+};
+
+/*!
+ * compare all lookups and the iteration order with std::map
+ */
+template <typename Key>
+static void check_equal(const variable_map<Key> &m, const std::map<Key, int> &reference) {
+	CHECK(m.size() == reference.size());
+	CHECK(m.empty() == reference.empty());
+	auto it = m.begin();
+	for (auto &r : reference) {
+		CHECK(it != m.end());
+		CHECK(it->first == r.first and it->second == r.second);
+		CHECK(m.at(r.first) == r.second);
+		CHECK(m.find(r.first) != m.end() and m.find(r.first)->second == r.second);
+		++it;
+	}
+	CHECK(it == m.end());
+}
+
+int main() {
+	std::mt19937 rng(42);
+	// random inserts in all dimensions (the map grows while it is filled)
+	{
+		variable_map<int> m;
+		std::map<int, int> reference;
+		for (int i = 1; i <= 200; i++) {
+			int key = (int)(rng() % 500);
+			m[key] = i;
+			reference[key] = i;
+		}
+		check_equal(m, reference);
+		CHECK(m.find(1000) == m.end());
+	}
+	{
+		variable_map<std::tuple<int, direction, int>> m;
+		std::map<std::tuple<int, direction, int>, int> reference;
+		for (int i = 1; i <= 500; i++) {
+			auto key = std::make_tuple((int)(rng() % 20), rng() % 2 == 0 ? left : right, (int)(rng() % 40));
+			m[key] = i;
+			reference[key] = i;
+		}
+		check_equal(m, reference);
+		CHECK(m.find({25, left, 0}) == m.end());
+		CHECK(m.find({0, left, 100}) == m.end());
+	}
+	{
+		variable_map<std::pair<int, int>> m;
+		std::map<std::pair<int, int>, int> reference;
+		check_equal(m, reference);
+		for (int i = 1; i <= 300; i++) {
+			auto key = std::make_pair((int)(rng() % 30), (int)(rng() % 30));
+			m[key] = i;
+			reference[key] = i;
+		}
+		check_equal(m, reference);
+		// entries without a variable are missing
+		m[{100, 100}];
+		check_equal(m, reference);
+		// clear keeps nothing
+		m.clear();
+		reference.clear();
+		check_equal(m, reference);
+		m[{3, 4}] = 7;
+		reference[{3, 4}] = 7;
+		check_equal(m, reference);
+	}
+	// errors
+	{
+		variable_map<std::pair<int, int>> m;
+		m[{1, 1}] = 1;
+		bool failed = false;
+		try {
+			m.at({1, 2});
+		}
+		catch (std::out_of_range &) {
+			failed = true;
+		}
+		CHECK(failed);
+		failed = false;
+		try {
+			m[{-1, 0}] = 2;
+		}
+		catch (std::out_of_range &) {
+			failed = true;
+		}
+		CHECK(failed);
+		CHECK(m.find({-1, 0}) == m.end());
+	}
+	std::cout << "passed" << std::endl;
+	return 0;
+}